@@ -0,0 +1,943 @@
+//===--- conversion_bench.cpp -----------------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Benchmark of text to number conversions.
+///
+/// The program converts reproducible datasets of numbers between text and
+/// binary form by functions of this library and by standard library
+/// functions, and reports time per number and throughput in JSON format.
+///
+/// If a baseline file is specified, results of this library functions are
+/// compared with it, and the program exits with code 2 if any of them is
+/// slower than the baseline by more than the threshold. The baseline is the
+/// JSON output of a previous run made with the same --count. Time of a
+/// function is compared as a ratio to the time of the standard function that
+/// does the same work, strtod, strtoll or snprintf, measured in alternating
+/// samples within the same run, so that the check does not depend on speed
+/// or load of the machine.
+///
+/// Usage: conversion_bench [options]
+///   --json FILE         write results to FILE instead of standard output
+///   --filter TEXT       run only benchmarks which name "dataset/kernel"
+///                       contains TEXT
+///   --count N           number of numbers in each dataset (default 100000)
+///   --min-time SEC      minimal measurement time of a benchmark (default 0.5)
+///   --repetitions N     number of time samples (default 7)
+///   --cpu-level NAME    use vectorized code not higher than the level
+///   --pin-cpu N         bind the process to processor N
+///   --baseline FILE     compare results with the baseline
+///   --threshold PCT     allowed slowdown in percents (default 25)
+///   --list              print benchmark names and exit
+///
+//===----------------------------------------------------------------------===//
+
+//------ Dependencies ----------------------------------------------------------
+#include "conversion/number_recognizer.h"
+#include "conversion/number_convert.h"
+#include "conversion/number_formatter.h"
+#include "conversion/strto.h"
+#include "conversion/cpu_dispatch.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#if defined(__linux__)
+#include <sched.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+#if defined(__has_include)
+#if __has_include(<charconv>) && __cplusplus >= 201703L
+#include <charconv>
+#endif
+#endif
+//------------------------------------------------------------------------------
+
+using namespace conversion;
+
+namespace {
+
+/// \brief Pseudo-random generator (xorshift64*).
+///
+/// Standard distributions produce different sequences in different library
+/// implementations, so datasets are generated by this simple generator to
+/// make them the same everywhere.
+///
+class Random {
+public:
+  explicit Random(uint64_t seed) : state(seed) {}
+
+  uint64_t next() {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 2685821657736338717ULL;
+  }
+
+  /// \brief Returns number in range [0, n).
+  unsigned below(unsigned n) { return static_cast<unsigned>(next() % n); }
+
+  char digit() { return static_cast<char>('0' + below(10)); }
+  char nonzero_digit() { return static_cast<char>('1' + below(9)); }
+
+private:
+  uint64_t state;
+};
+
+
+/// \brief Set of number texts of similar kind.
+///
+/// Texts are stored in single buffer, each is followed by null character, so
+/// that they may be passed to C library functions directly.
+///
+struct Dataset {
+  std::string name;
+  bool is_float;            ///< Texts represent floating point numbers
+  int base;                 ///< Base of integer numbers
+  unsigned options;         ///< Recognizer options
+  std::string buffer;
+  std::vector<unsigned> offsets;
+  std::vector<unsigned> lengths;
+  std::vector<long long> int_values;  ///< Values obtained by strtoll
+  std::vector<double> float_values;   ///< Values obtained by strtod
+
+  size_t size() const { return offsets.size(); }
+  const char *text(size_t i) const { return buffer.data() + offsets[i]; }
+  size_t text_bytes() const { return buffer.size() - size(); }
+
+  void add(const std::string &text) {
+    offsets.push_back(static_cast<unsigned>(buffer.size()));
+    lengths.push_back(static_cast<unsigned>(text.size()));
+    buffer += text;
+    buffer += '\0';
+  }
+};
+
+
+typedef std::string (*Generator)(Random &);
+
+std::string make_short_int(Random &rnd) {
+  std::string text;
+  if (rnd.below(4) == 0)
+    text += '-';
+  unsigned len = 1 + rnd.below(4);
+  text += len == 1 ? rnd.digit() : rnd.nonzero_digit();
+  while (text.size() < len + (text[0] == '-'))
+    text += rnd.digit();
+  return text;
+}
+
+std::string make_id(Random &rnd) {
+  // 19 digits, below 9223372036854775807.
+  std::string text(1, static_cast<char>('1' + rnd.below(8)));
+  while (text.size() < 19)
+    text += rnd.digit();
+  return text;
+}
+
+std::string make_price(Random &rnd) {
+  std::string text(1, rnd.nonzero_digit());
+  for (unsigned len = rnd.below(6); len; --len)
+    text += rnd.digit();
+  text += '.';
+  for (unsigned len = 2 + rnd.below(7); len; --len)
+    text += rnd.digit();
+  return text;
+}
+
+std::string make_scientific(Random &rnd) {
+  std::string text;
+  if (rnd.below(2))
+    text += '-';
+  text += rnd.nonzero_digit();
+  text += '.';
+  for (unsigned len = 1 + rnd.below(16); len; --len)
+    text += rnd.digit();
+  text += rnd.below(2) ? "e-" : "e+";
+  text += std::to_string(rnd.below(300));
+  return text;
+}
+
+std::string make_hex(Random &rnd) {
+  static const char digits[] = "0123456789abcdef";
+  std::string text = "0x";
+  text += digits[1 + rnd.below(15)];
+  for (unsigned len = rnd.below(15); len; --len)
+    text += digits[rnd.below(16)];
+  return text;
+}
+
+std::string make_padded(Random &rnd) {
+  std::string text(1 + rnd.below(8), ' ');
+  text += make_short_int(rnd);
+  text += std::string(rnd.below(8), ' ');
+  return text;
+}
+
+std::string make_malformed(Random &rnd) {
+  static const char *const samples[] = {
+    "", "-", "+-1", "12a4", "0x", "abc", "1e", "--5", ".", "1.2.3", "e5",
+    "9223372036854775808", "1 2", "nan"
+  };
+  return samples[rnd.below(sizeof(samples) / sizeof(samples[0]))];
+}
+
+
+Dataset make_dataset(const char *name, bool is_float, int base,
+                     unsigned options, Generator gen, size_t count,
+                     uint64_t seed) {
+  Dataset data;
+  data.name = name;
+  data.is_float = is_float;
+  data.base = base;
+  data.options = options;
+  Random rnd(seed);
+  for (size_t i = 0; i < count; ++i)
+    data.add(gen(rnd));
+  for (size_t i = 0; i < count; ++i) {
+    data.int_values.push_back(strtoll(data.text(i), nullptr, base));
+    data.float_values.push_back(strtod(data.text(i), nullptr));
+  }
+  return data;
+}
+
+
+std::vector<Dataset> make_datasets(size_t count) {
+  std::vector<Dataset> result;
+  result.push_back(make_dataset("short_ints", false, 10, 0, make_short_int,
+                                count, 1));
+  result.push_back(make_dataset("ids", false, 10, 0, make_id, count, 2));
+  result.push_back(make_dataset("prices", true, 10, DefaultOptions,
+                                make_price, count, 3));
+  result.push_back(make_dataset("scientific", true, 10, DefaultOptions,
+                                make_scientific, count, 4));
+  result.push_back(make_dataset("hex", false, 16, Prefix0x, make_hex,
+                                count, 5));
+  result.push_back(make_dataset("padded", false, 10, 0, make_padded,
+                                count, 6));
+  result.push_back(make_dataset("malformed", true, 10, DefaultOptions,
+                                make_malformed, count, 7));
+  return result;
+}
+
+
+// Helpers that skip parts of text not accepted by low level functions.
+
+const char *skip_spaces(const char *str, const char *end) {
+  while (str != end && *str == ' ')
+    ++str;
+  return str;
+}
+
+const char *skip_prefix(const Dataset &data, const char *str,
+                        const char *end) {
+  if (data.base == 16 && end - str > 2 && str[0] == '0' && str[1] == 'x')
+    return str + 2;
+  return str;
+}
+
+
+// Kernels. Each converts all texts of the dataset and returns a checksum,
+// which prevents the compiler from discarding the work.
+
+double run_recognizer(const Dataset &data) {
+  double sum = 0;
+  NumberRecognizer<> recog(data.options);
+  for (size_t i = 0; i < data.size(); ++i) {
+    recog.init(data.text(i), data.lengths[i], data.options);
+    recog.recognize();
+    if (data.is_float) {
+      double value;
+      recog.read(value);
+      sum += value;
+    } else {
+      long long value;
+      recog.read(value);
+      sum += static_cast<double>(value);
+    }
+  }
+  return sum;
+}
+
+double run_read_fixed(const Dataset &data) {
+  double sum = 0;
+  NumberRecognizer<> recog(data.options);
+  for (size_t i = 0; i < data.size(); ++i) {
+    recog.init(data.text(i), data.lengths[i], data.options);
+    long long value;
+    recog.read_fixed<long long, 8>(value);
+    sum += static_cast<double>(value);
+  }
+  return sum;
+}
+
+double run_convert_int(const Dataset &data) {
+  double sum = 0;
+  for (size_t i = 0; i < data.size(); ++i) {
+    const char *str = data.text(i);
+    const char *end = str + data.lengths[i];
+    str = skip_prefix(data, skip_spaces(str, end), end);
+    bool negative = str != end && *str == '-';
+    str += negative;
+    unsigned long long value;
+    convert_int(value, str, static_cast<unsigned>(end - str),
+                static_cast<unsigned char>(data.base));
+    sum += negative ? -static_cast<double>(value) : static_cast<double>(value);
+  }
+  return sum;
+}
+
+double run_strto(const Dataset &data) {
+  double sum = 0;
+  for (size_t i = 0; i < data.size(); ++i) {
+    int status;
+    if (data.is_float)
+      sum += strto<double, char>(data.text(i), data.lengths[i], nullptr, 10,
+                                 &status);
+    else
+      sum += static_cast<double>(strto<long long, char>(
+        data.text(i), data.lengths[i], nullptr, data.base, &status));
+  }
+  return sum;
+}
+
+double run_convert_to(const Dataset &data) {
+  double sum = 0;
+  if (data.is_float) {
+    for (double value : data.float_values)
+      sum += convert_to<float>(value).value();
+  } else {
+    for (long long value : data.int_values)
+      sum += convert_to<int>(value).value();
+  }
+  return sum;
+}
+
+double run_strtod(const Dataset &data) {
+  double sum = 0;
+  for (size_t i = 0; i < data.size(); ++i)
+    sum += strtod(data.text(i), nullptr);
+  return sum;
+}
+
+double run_strtoll(const Dataset &data) {
+  double sum = 0;
+  for (size_t i = 0; i < data.size(); ++i)
+    sum += static_cast<double>(strtoll(data.text(i), nullptr, data.base));
+  return sum;
+}
+
+#if defined(__cpp_lib_to_chars)
+double run_from_chars(const Dataset &data) {
+  double sum = 0;
+  for (size_t i = 0; i < data.size(); ++i) {
+    const char *str = data.text(i);
+    const char *end = str + data.lengths[i];
+    str = skip_prefix(data, skip_spaces(str, end), end);
+    if (data.is_float) {
+      double value = 0;
+      std::from_chars(str, end, value);
+      sum += value;
+    } else {
+      long long value = 0;
+      std::from_chars(str, end, value, data.base);
+      sum += static_cast<double>(value);
+    }
+  }
+  return sum;
+}
+#endif
+
+
+double run_format_int(const Dataset &data) {
+  double sum = 0;
+  char buf[MaxIntTextLength];
+  for (long long value : data.int_values)
+    sum += format_int(buf, sizeof(buf), value, data.base);
+  return sum;
+}
+
+double run_format_float(const Dataset &data) {
+  double sum = 0;
+  char buf[32];
+  for (double value : data.float_values)
+    sum += format_float(buf, sizeof(buf), value);
+  return sum;
+}
+
+double run_snprintf(const Dataset &data) {
+  double sum = 0;
+  char buf[32];
+  if (data.is_float) {
+    for (double value : data.float_values)
+      sum += snprintf(buf, sizeof(buf), "%.17g", value);
+  } else {
+    const char *format = data.base == 16 ? "%llx" : "%lld";
+    for (long long value : data.int_values)
+      sum += snprintf(buf, sizeof(buf), format, value);
+  }
+  return sum;
+}
+
+
+/// \brief Conversion function measured by the benchmark.
+struct Kernel {
+  const char *name;
+  double (*run)(const Dataset &);
+  bool for_ints;          ///< Applicable to integer datasets
+  bool for_floats;        ///< Applicable to floating point datasets
+  bool parses_text;       ///< Throughput in bytes is meaningful
+  bool gated;             ///< Function of this library, checked for regression
+};
+
+const Kernel kernels[] = {
+  { "recognizer", run_recognizer, true, true, true, true },
+  { "read_fixed", run_read_fixed, false, true, true, true },
+  { "convert_int", run_convert_int, true, false, true, true },
+  { "strto", run_strto, true, true, true, true },
+  { "convert_to", run_convert_to, true, true, false, false },
+  { "format_int", run_format_int, true, false, false, true },
+  { "format_float", run_format_float, false, true, false, true },
+  { "strtod", run_strtod, false, true, true, false },
+  { "strtoll", run_strtoll, true, false, true, false },
+#if defined(__cpp_lib_to_chars)
+  { "from_chars", run_from_chars, true, true, true, false },
+#endif
+  { "snprintf", run_snprintf, true, true, false, false },
+};
+
+
+/// \brief Benchmark settings.
+struct Settings {
+  size_t count = 100000;          ///< Numbers in each dataset
+  double min_time = 0.5;          ///< Minimal measurement time, seconds
+  unsigned repetitions = 7;       ///< Number of samples
+  double threshold = 25;          ///< Allowed slowdown, percent
+};
+
+
+/// \brief Result of a benchmark.
+struct Measurement {
+  double best_ns;         ///< Time per number in the fastest sample
+  double median_ns;       ///< Median time per number of accepted samples
+  unsigned rejected;      ///< Number of samples rejected as outliers
+  double checksum;        ///< Result of single run, allows comparing kernels
+  double relative;        ///< Median ratio of sample time to the time of the
+                          ///< reference kernel, zero if it is not measured
+};
+
+
+/// Receives results of repeated runs, so that they are not optimized away.
+volatile double sink;
+
+
+double median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  size_t n = values.size();
+  return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+}
+
+
+/// \brief Returns median of the values that deviate from the median by no
+/// more than three scaled median absolute deviations.
+///
+/// Rejected values are usually caused by interrupts or other processes.
+///
+double robust_median(const std::vector<double> &values, unsigned &rejected) {
+  double center = median(values);
+  std::vector<double> deviations;
+  for (double t : values)
+    deviations.push_back(std::fabs(t - center));
+  double limit = 3 * 1.4826 * median(deviations);
+  std::vector<double> accepted;
+  for (double t : values)
+    if (std::fabs(t - center) <= limit)
+      accepted.push_back(t);
+  rejected = static_cast<unsigned>(values.size() - accepted.size());
+  return median(accepted);
+}
+
+
+/// \brief Runs the kernel the specified number of times and returns time per
+/// number.
+///
+double run_sample(const Kernel &kernel, const Dataset &data, unsigned reps,
+                  double &sum) {
+  typedef std::chrono::steady_clock Clock;
+  Clock::time_point start = Clock::now();
+  for (unsigned i = 0; i < reps; ++i)
+    sum += kernel.run(data);
+  double elapsed = std::chrono::duration<double, std::nano>(
+    Clock::now() - start).count();
+  return elapsed / (double(reps) * data.size());
+}
+
+
+/// \brief Chooses number of kernel runs in a sample, so that all samples take
+/// at least the minimal time.
+///
+unsigned calibrate(const Kernel &kernel, const Dataset &data,
+                   const Settings &settings, double &sum) {
+  const double min_sample_ns = settings.min_time * 1e9 / settings.repetitions;
+  unsigned reps = 1;
+  while (run_sample(kernel, data, reps, sum) * reps * data.size() <
+           min_sample_ns && reps < (1U << 20))
+    reps *= 2;
+  return reps;
+}
+
+
+/// \brief Runs the kernel repeatedly and measures time per number.
+///
+/// Time is measured in several samples, each running the kernel enough times
+/// to take a fraction of the minimal time. Samples that deviate from the
+/// median by more than three scaled median absolute deviations are rejected
+/// as outliers.
+///
+/// If the reference kernel is specified, each sample is followed by a sample
+/// of the reference, and the ratio of their times is calculated. Both samples
+/// of a pair run under the same machine load, so the ratio is much more
+/// stable than the times themselves.
+///
+Measurement measure(const Kernel &kernel, const Dataset &data,
+                    const Settings &settings,
+                    const Kernel *reference = nullptr) {
+  const unsigned samples = settings.repetitions;
+  Measurement result;
+  result.checksum = kernel.run(data);   // Also warms up caches
+  double sum = 0;
+
+  unsigned reps = calibrate(kernel, data, settings, sum);
+  unsigned ref_reps = 0;
+  if (reference) {
+    reference->run(data);
+    ref_reps = calibrate(*reference, data, settings, sum);
+  }
+
+  std::vector<double> times, ratios;
+  for (unsigned s = 0; s < samples; ++s) {
+    double time = run_sample(kernel, data, reps, sum);
+    times.push_back(time);
+    if (reference)
+      ratios.push_back(time / run_sample(*reference, data, ref_reps, sum));
+  }
+  sink = sum;
+
+  result.best_ns = *std::min_element(times.begin(), times.end());
+  result.median_ns = robust_median(times, result.rejected);
+  unsigned ratio_rejected;
+  result.relative = reference ? robust_median(ratios, ratio_rejected) : 0;
+  return result;
+}
+
+
+/// \brief Returns standard function that does the same work as the kernel.
+///
+/// Time of the kernel is compared with the baseline as a ratio to the time of
+/// this function.
+///
+const Kernel *reference_kernel(const Kernel &kernel, const Dataset &data) {
+  const char *name = !kernel.parses_text ? "snprintf"
+                   : data.is_float ? "strtod" : "strtoll";
+  for (const Kernel &candidate : kernels)
+    if (strcmp(candidate.name, name) == 0)
+      return &candidate;
+  return nullptr;
+}
+
+
+/// \brief Binds the process to the specified processor, so that measurements
+/// are not disturbed by migration between processors.
+///
+bool pin_to_cpu(unsigned cpu) {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+  return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+#else
+  (void)cpu;
+  return false;
+#endif
+}
+
+
+/// \brief Minimal reader of JSON, sufficient for baseline files.
+///
+/// Values of interest are collected while parsing: for each object that has
+/// members "name" and "relative_time", the pair is stored.
+///
+class BaselineReader {
+public:
+  explicit BaselineReader(const std::string &text)
+    : cursor(text.c_str()), end(text.c_str() + text.size()) {}
+
+  /// \brief Parses the text.
+  ///
+  /// \returns False if the text is not valid JSON.
+  ///
+  bool parse(std::vector<std::pair<std::string, double>> &result) {
+    entries = &result;
+    double number;
+    std::string str;
+    if (!parse_value(str, number))
+      return false;
+    skip_spaces();
+    return cursor == end;
+  }
+
+private:
+  const char *cursor;
+  const char *end;
+  std::vector<std::pair<std::string, double>> *entries;
+
+  void skip_spaces() {
+    while (cursor != end && (*cursor == ' ' || *cursor == '\t' ||
+                             *cursor == '\n' || *cursor == '\r'))
+      ++cursor;
+  }
+
+  bool expect(char ch) {
+    skip_spaces();
+    if (cursor == end || *cursor != ch)
+      return false;
+    ++cursor;
+    return true;
+  }
+
+  bool parse_string(std::string &str) {
+    if (!expect('"'))
+      return false;
+    str.clear();
+    while (cursor != end && *cursor != '"') {
+      if (*cursor == '\\' && ++cursor == end)
+        return false;
+      str += *cursor++;
+    }
+    return expect('"');
+  }
+
+  bool parse_object() {
+    bool has_name = false, has_time = false;
+    std::string name;
+    double time = 0;
+    if (expect('}'))
+      return true;
+    do {
+      std::string key, str;
+      double number;
+      if (!parse_string(key) || !expect(':') || !parse_value(str, number))
+        return false;
+      if (key == "name") {
+        name = str;
+        has_name = true;
+      } else if (key == "relative_time") {
+        time = number;
+        has_time = true;
+      }
+    } while (expect(','));
+    if (has_name && has_time)
+      entries->push_back(std::make_pair(name, time));
+    return expect('}');
+  }
+
+  bool parse_array() {
+    if (expect(']'))
+      return true;
+    do {
+      std::string str;
+      double number;
+      if (!parse_value(str, number))
+        return false;
+    } while (expect(','));
+    return expect(']');
+  }
+
+  bool parse_value(std::string &str, double &number) {
+    skip_spaces();
+    if (cursor == end)
+      return false;
+    number = 0;
+    if (*cursor == '"')
+      return parse_string(str);
+    if (*cursor == '{') {
+      ++cursor;
+      return parse_object();
+    }
+    if (*cursor == '[') {
+      ++cursor;
+      return parse_array();
+    }
+    for (const char *word : { "null", "true", "false" }) {
+      size_t len = strlen(word);
+      if (size_t(end - cursor) >= len && strncmp(cursor, word, len) == 0) {
+        cursor += len;
+        return true;
+      }
+    }
+    char *number_end;
+    number = strtod(cursor, &number_end);
+    if (number_end == cursor)
+      return false;
+    cursor = number_end;
+    return true;
+  }
+};
+
+
+bool read_baseline(const char *file_name,
+                   std::vector<std::pair<std::string, double>> &baseline) {
+  FILE *in = fopen(file_name, "rb");
+  if (!in) {
+    fprintf(stderr, "Cannot open baseline '%s'\n", file_name);
+    return false;
+  }
+  std::string text;
+  char buf[4096];
+  size_t len;
+  while ((len = fread(buf, 1, sizeof(buf), in)) != 0)
+    text.append(buf, len);
+  fclose(in);
+  if (!BaselineReader(text).parse(baseline)) {
+    fprintf(stderr, "Baseline '%s' is not valid JSON\n", file_name);
+    return false;
+  }
+  return true;
+}
+
+
+void write_string(FILE *out, const std::string &str) {
+  fputc('"', out);
+  for (char ch : str) {
+    if (ch == '"' || ch == '\\')
+      fputc('\\', out);
+    fputc(ch, out);
+  }
+  fputc('"', out);
+}
+
+
+const char *compiler_name() {
+#if defined(__clang__)
+  return "clang " __clang_version__;
+#elif defined(__GNUC__)
+  return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+  return "msvc";
+#else
+  return "unknown";
+#endif
+}
+
+
+void usage() {
+  fprintf(stderr, "Usage: conversion_bench [--json FILE] [--filter TEXT] "
+                  "[--count N] [--min-time SEC] [--repetitions N] "
+                  "[--cpu-level NAME] [--pin-cpu N] [--baseline FILE] "
+                  "[--threshold PERCENT] [--list]\n");
+}
+
+}
+
+
+int main(int argc, char *argv[]) {
+  Settings settings;
+  const char *json_file = nullptr;
+  const char *baseline_file = nullptr;
+  std::string filter;
+  bool list_only = false;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool has_value = i + 1 < argc;
+    if (arg == "--json" && has_value) {
+      json_file = argv[++i];
+    } else if (arg == "--filter" && has_value) {
+      filter = argv[++i];
+    } else if (arg == "--count" && has_value) {
+      settings.count = strtoul(argv[++i], nullptr, 10);
+    } else if (arg == "--min-time" && has_value) {
+      settings.min_time = strtod(argv[++i], nullptr);
+    } else if (arg == "--repetitions" && has_value) {
+      settings.repetitions = static_cast<unsigned>(
+        strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--baseline" && has_value) {
+      baseline_file = argv[++i];
+    } else if (arg == "--threshold" && has_value) {
+      settings.threshold = strtod(argv[++i], nullptr);
+    } else if (arg == "--pin-cpu" && has_value) {
+      unsigned cpu = static_cast<unsigned>(strtoul(argv[++i], nullptr, 10));
+      if (!pin_to_cpu(cpu)) {
+        fprintf(stderr, "Cannot bind to processor %u\n", cpu);
+        return 1;
+      }
+    } else if (arg == "--cpu-level" && has_value) {
+      std::string name = argv[++i];
+      bool found = false;
+      for (int level = ScalarLevel; level < CpuLevelCount; ++level) {
+        if (name == get_cpu_level_name(static_cast<CpuLevel>(level))) {
+          found = set_cpu_level(static_cast<CpuLevel>(level));
+          break;
+        }
+      }
+      if (!found) {
+        fprintf(stderr, "Level '%s' is unknown or not supported\n",
+                name.c_str());
+        return 1;
+      }
+    } else if (arg == "--list") {
+      list_only = true;
+    } else {
+      usage();
+      return 1;
+    }
+  }
+  if (settings.count == 0 || settings.repetitions == 0) {
+    usage();
+    return 1;
+  }
+
+  std::vector<std::pair<std::string, double>> baseline;
+  if (baseline_file && !read_baseline(baseline_file, baseline))
+    return 1;
+
+  std::vector<Dataset> datasets = make_datasets(settings.count);
+
+  FILE *out = stdout;
+  if (json_file && !list_only) {
+    out = fopen(json_file, "w");
+    if (!out) {
+      fprintf(stderr, "Cannot open '%s'\n", json_file);
+      return 1;
+    }
+  }
+
+  if (!list_only) {
+    fprintf(out, "{\n  \"version\": 2,\n  \"compiler\": ");
+    write_string(out, compiler_name());
+    fprintf(out, ",\n  \"cpu_level\": \"%s\",\n  \"count\": %zu,\n"
+                 "  \"repetitions\": %u,\n  \"results\": [",
+            get_cpu_level_name(get_cpu_level()), settings.count,
+            settings.repetitions);
+  }
+
+  bool first = true;
+  unsigned regressions = 0;
+  for (const Dataset &data : datasets) {
+    for (const Kernel &kernel : kernels) {
+      if (!(data.is_float ? kernel.for_floats : kernel.for_ints))
+        continue;
+      std::string name = data.name + "/" + kernel.name;
+      if (name.find(filter) == std::string::npos)
+        continue;
+      if (list_only) {
+        printf("%s\n", name.c_str());
+        continue;
+      }
+
+      // Only functions of this library are checked, standard functions are
+      // measured for reference. Apparent regression is measured again to
+      // filter out transient machine load.
+      const Kernel *ref_kernel =
+        kernel.gated ? reference_kernel(kernel, data) : nullptr;
+      Measurement m = measure(kernel, data, settings, ref_kernel);
+      double reference = 0;
+      if (ref_kernel) {
+        for (const auto &entry : baseline)
+          if (entry.first == name)
+            reference = entry.second;
+      }
+      double limit = reference * (1 + settings.threshold / 100);
+      if (reference > 0 && m.relative > limit) {
+        Measurement again = measure(kernel, data, settings, ref_kernel);
+        if (again.relative < m.relative)
+          m = again;
+      }
+
+      fprintf(out, "%s\n    {\"name\": ", first ? "" : ",");
+      write_string(out, name);
+      fprintf(out, ", \"dataset\": \"%s\", \"kernel\": \"%s\", "
+                   "\"bytes\": %zu, \"ns_per_number\": %.3f, "
+                   "\"median_ns_per_number\": %.3f, \"rejected\": %u, "
+                   "\"mb_per_s\": ",
+              data.name.c_str(), kernel.name, data.text_bytes(),
+              m.best_ns, m.median_ns, m.rejected);
+      if (kernel.parses_text) {
+        double bytes_per_number = double(data.text_bytes()) / data.size();
+        fprintf(out, "%.1f", bytes_per_number / m.median_ns * 1000);
+      } else {
+        fprintf(out, "null");
+      }
+      fprintf(out, ", \"checksum\": ");
+      if (std::isfinite(m.checksum))
+        fprintf(out, "%.17g", m.checksum);
+      else
+        fprintf(out, "null");
+
+      if (ref_kernel)
+        fprintf(out, ", \"reference\": \"%s\", \"relative_time\": %.4f",
+                ref_kernel->name, m.relative);
+      if (reference > 0) {
+        double change = (m.relative / reference - 1) * 100;
+        bool regressed = m.relative > limit;
+        fprintf(out, ", \"baseline_relative_time\": %.4f, "
+                     "\"change_percent\": %.1f, \"regression\": %s",
+                reference, change, regressed ? "true" : "false");
+        if (regressed) {
+          ++regressions;
+          fprintf(stderr, "REGRESSION %s: %.4f of %s time, baseline %.4f, "
+                          "%+.1f%%\n", name.c_str(), m.relative,
+                  ref_kernel->name, reference, change);
+        }
+      }
+      fprintf(out, "}");
+      fflush(out);
+      first = false;
+    }
+  }
+
+  if (!list_only) {
+    fprintf(out, "\n  ]\n}\n");
+    if (out != stdout)
+      fclose(out);
+  }
+  if (regressions) {
+    fprintf(stderr, "%u benchmark(s) are slower than the baseline by more "
+                    "than %.1f%%\n", regressions, settings.threshold);
+    return 2;
+  }
+  return 0;
+}
@@ -168,6 +168,7 @@ endfunction(make_component_library)
 # Result:
 #    Creates executable for the unit tests, like "NumberRecognizerTests"
 #    Creates target "check-number-recognizer" that runs the test
+#    Registers the executable as a test for ctest
 #
 function(make_component_tests name)
   if (NOT CURRENT_COMPONENT_NAME)
@@ -199,6 +200,7 @@ function(make_component_tests name)
   target_link_libraries (${project_name}Tests ${Boost_UNIT_TEST_FRAMEWORK_LIBRARY})
 
   set(${project_name}_test_location $<TARGET_FILE:${project_name}Tests>)
+  add_test(NAME ${project_name}Tests COMMAND ${${project_name}_test_location})
   add_custom_target(check-${CURRENT_COMPONENT_NAME}
     COMMAND ${${project_name}_test_location}
     DEPENDS ${project_name}Tests
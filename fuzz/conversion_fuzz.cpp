@@ -0,0 +1,809 @@
+//===--- conversion_fuzz.cpp ------------------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Differential fuzzing of text to number conversion.
+///
+/// Each input is recognized by NumberRecognizer and converted to every
+/// arithmetic type, the results are compared with the results of standard
+/// functions strtof, strtod, strtoll and strtoull. Each input is checked with
+/// default recognizer options, with hexadecimal prefix allowed and with
+/// hexadecimal float notation allowed.
+///
+/// A result is compared as a pair of value and status. The standard functions
+/// report range errors by errno, such results are translated into statuses the
+/// way convert_to reports them: integer overflow saturates the value, float
+/// overflow produces the maximal finite value, underflow produces zero.
+/// Values of type long double are obtained through double, so strtod is the
+/// reference for them as well.
+///
+/// If compiled with CONVERSION_LIBFUZZER defined, the file only provides entry
+/// point for libFuzzer, which aborts on the first mismatch. Otherwise the
+/// program checks inputs read from files and generated inputs, then reports
+/// throughput of each conversion path on them.
+///
+/// Usage: conversion_fuzz [options] [FILE | DIRECTORY]...
+///   --random N    check also N generated inputs (default 100000 if no files
+///                 are specified)
+///   --seed S      seed of the input generator (default 1)
+///   --no-timing   do not measure throughput
+///
+//===----------------------------------------------------------------------===//
+
+//------ Dependencies ----------------------------------------------------------
+#include "conversion/number_recognizer.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+#if !defined(CONVERSION_LIBFUZZER)
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#endif
+//------------------------------------------------------------------------------
+
+using namespace conversion;
+
+namespace {
+
+/// Inputs longer than this are truncated.
+const size_t MaxInputLength = 1024;
+
+/// Maximal number of mismatches printed.
+const unsigned long MaxReported = 20;
+
+/// Recognizer options with which each input is checked.
+const unsigned CheckedOptions[] = {
+  DefaultOptions, DefaultOptions | Prefix0x,
+  DefaultOptions | Prefix0x | HexFloating
+};
+
+const char *const StatusNames[] = {
+  "OK", "NegativeLimit", "DoubleToInt", "IntToDouble", "IntOverflow",
+  "IntOverflowNegative", "DoubleOverflow", "DoubleOverflowNegative",
+  "DoubleUnderflow", "NaN"
+};
+
+bool abort_on_mismatch = false;
+unsigned long mismatch_count = 0;
+
+
+/// \brief Returns the text in quotes, with unprintable characters escaped.
+///
+std::string quote(const char *str, size_t len) {
+  std::string result = "\"";
+  for (size_t i = 0; i < len; ++i) {
+    unsigned char ch = static_cast<unsigned char>(str[i]);
+    if (ch == '"' || ch == '\\') {
+      result += '\\';
+      result += static_cast<char>(ch);
+    } else if (ch >= 0x20 && ch < 0x7F) {
+      result += static_cast<char>(ch);
+    } else {
+      char buf[8];
+      snprintf(buf, sizeof(buf), "\\x%02x", ch);
+      result += buf;
+    }
+  }
+  return result + "\"";
+}
+
+
+void report(const char *str, unsigned len, unsigned options, const char *what,
+            const std::string &message) {
+  if (++mismatch_count <= MaxReported)
+    fprintf(stderr, "MISMATCH %s, options 0x%x, %s: %s\n",
+            quote(str, len).c_str(), options, what, message.c_str());
+  if (abort_on_mismatch)
+    abort();
+}
+
+
+/// \brief Result of conversion in the form that allows comparing results
+/// obtained for different types.
+///
+struct Outcome {
+  std::string value;    ///< Exact textual representation of the value
+  Status status;
+
+  bool operator == (const Outcome &x) const {
+    return value == x.value && status == x.status;
+  }
+
+  std::string str() const {
+    return value + " (" + StatusNames[status] + ")";
+  }
+};
+
+
+template<typename T>
+Outcome make_outcome(T value, Status status) {
+  char buf[64];
+  if (std::numeric_limits<T>::is_integer) {
+    if (std::numeric_limits<T>::is_signed)
+      snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(value));
+    else
+      snprintf(buf, sizeof(buf), "%llu",
+               static_cast<unsigned long long>(value));
+  } else {
+    snprintf(buf, sizeof(buf), "%La", static_cast<long double>(value));
+  }
+  Outcome result;
+  result.value = buf;
+  result.status = status;
+  return result;
+}
+
+
+/// \brief Number found by the recognizer.
+///
+struct NumberText {
+  std::string text;     ///< Number without surrounding spaces
+  unsigned base;
+  bool is_float;        ///< Number is written in float notation
+  bool is_negative;
+};
+
+
+/// \brief Moves the point in a sequence of digits and returns digits that
+/// precede it.
+///
+/// \param digits   Digits of the number without the point.
+/// \param point    Position of the point in digits, may be outside them.
+/// \param fraction Set to true if nonzero digits follow the point.
+///
+std::string shift_point(const std::string &digits, long long point,
+                        bool &fraction) {
+  size_t first = digits.find_first_not_of('0');
+  if (first == std::string::npos) {
+    fraction = false;
+    return "0";
+  }
+  if (point <= static_cast<long long>(first)) {
+    fraction = true;
+    return "0";
+  }
+  if (point >= static_cast<long long>(digits.size())) {
+    fraction = false;
+    return digits + std::string(point - digits.size(), '0');
+  }
+  fraction = digits.find_first_not_of('0', point) != std::string::npos;
+  return digits.substr(0, point);
+}
+
+
+/// \brief Reads exponent that starts at the given position of the text.
+///
+long long exponent_at(const std::string &text, size_t pos) {
+  if (pos >= text.size())
+    return 0;
+  return std::max(-100000LL, std::min(100000LL,
+                  strtoll(text.c_str() + pos + 1, nullptr, 10)));
+}
+
+
+/// \brief Moves decimal point of a number in float notation according to the
+/// exponent and returns digits of the integer part.
+///
+/// \param text     Decimal number without sign.
+/// \param fraction Set to true if nonzero digits follow the point.
+///
+std::string integer_digits(const std::string &text, bool &fraction) {
+  std::string digits;
+  size_t pos = 0;
+  long long point = -1;
+  for (; pos < text.size() && (isdigit(text[pos]) || text[pos] == '.'); ++pos)
+    if (text[pos] == '.')
+      point = digits.size();
+    else
+      digits += text[pos];
+  if (point < 0)
+    point = digits.size();
+  return shift_point(digits, point + exponent_at(text, pos), fraction);
+}
+
+
+/// \brief Moves binary point of a number in hexadecimal float notation
+/// according to the exponent and returns binary digits of the integer part.
+///
+/// \param text     Hexadecimal number with prefix and without sign.
+/// \param fraction Set to true if nonzero bits follow the point.
+///
+std::string binary_integer_digits(const std::string &text, bool &fraction) {
+  std::string digits;
+  size_t pos = 2;
+  long long point = -1;
+  for (; pos < text.size() && (isxdigit(text[pos]) || text[pos] == '.'); ++pos)
+    if (text[pos] == '.') {
+      point = digits.size();
+    } else {
+      unsigned digit = isdigit(text[pos]) ? text[pos] - '0'
+                                          : (text[pos] | 0x20) - 'a' + 10;
+      for (int bit = 3; bit >= 0; --bit)
+        digits += static_cast<char>('0' + ((digit >> bit) & 1));
+    }
+  if (point < 0)
+    point = digits.size();
+  return shift_point(digits, point + exponent_at(text, pos), fraction);
+}
+
+
+/// \brief Expected result of conversion to integer type, obtained by
+/// strtoull.
+///
+/// The function reads absolute value, as strtoull negates negative numbers.
+/// Positive value equal to the absolute value of the minimal one is reported
+/// by status NegativeLimit. Numbers in float notation are truncated, status
+/// DoubleToInt is reported if the fraction is not zero. Hexadecimal float
+/// numbers are read as binary digits.
+///
+template<typename T>
+Outcome reference(const NumberText &num, std::true_type) {
+  typedef std::numeric_limits<T> Limits;
+  const unsigned long long max_value = Limits::max();
+  std::string digits = num.text.substr(num.text[0] == '+' || num.is_negative);
+  bool fraction = false;
+  unsigned base = num.base;
+  if (num.is_float && base == 16) {
+    digits = binary_integer_digits(digits, fraction);
+    base = 2;
+  } else if (num.is_float) {
+    digits = integer_digits(digits, fraction);
+  }
+  const Status exact = fraction ? DoubleToInt : OK;
+
+  errno = 0;
+  unsigned long long value = strtoull(digits.c_str(), nullptr, base);
+  bool range_error = errno == ERANGE;
+  if (num.is_negative) {
+    if (value == 0 && !range_error)
+      return make_outcome(T(0), exact);
+    if (range_error || value > max_value + Limits::is_signed ||
+        !Limits::is_signed)
+      return make_outcome(Limits::min(), IntOverflowNegative);
+    return make_outcome(static_cast<T>(0 - value), exact);
+  }
+  if (range_error || value > max_value + Limits::is_signed)
+    return make_outcome(Limits::max(), IntOverflow);
+  if (value > max_value)
+    return make_outcome(Limits::max(), NegativeLimit);
+  return make_outcome(static_cast<T>(value), exact);
+}
+
+
+/// \brief Standard function used as reference for a float type.
+///
+template<typename T>
+struct StandardFloat {
+  typedef double type;
+  static double convert(const char *str) { return strtod(str, nullptr); }
+};
+
+template<>
+struct StandardFloat<float> {
+  typedef float type;
+
+  /// strtof of glibc rounds some hexadecimal numbers in the denormal range
+  /// to zero, so such numbers are read by strtod and rounded to float. The
+  /// double rounding is exact if the number has at most 53 significant bits.
+  static float convert(const char *str) {
+    float result = strtof(str, nullptr);
+    if (std::fabs(result) >= std::numeric_limits<float>::min() ||
+        !strpbrk(str, "xX"))
+      return result;
+    errno = 0;
+    double value = strtod(str, nullptr);
+    result = static_cast<float>(value);
+    if (result == 0 && value != 0)
+      errno = ERANGE;
+    return result;
+  }
+};
+
+
+/// \brief Expected result of conversion to float type, obtained by strtof or
+/// strtod.
+///
+template<typename T>
+Outcome reference(const NumberText &num, std::false_type) {
+  typedef typename StandardFloat<T>::type ReferenceType;
+  const ReferenceType max_value = std::numeric_limits<ReferenceType>::max();
+  errno = 0;
+  ReferenceType value = StandardFloat<T>::convert(num.text.c_str());
+  if (errno == ERANGE && std::isinf(value)) {
+    if (value < 0)
+      return make_outcome(static_cast<T>(-max_value), DoubleOverflowNegative);
+    return make_outcome(static_cast<T>(max_value), DoubleOverflow);
+  }
+  if (errno == ERANGE && value == 0)
+    return make_outcome(static_cast<T>(value), DoubleUnderflow);
+  return make_outcome(static_cast<T>(value), OK);
+}
+
+
+/// \brief Compares conversion made by the recognizer with the reference.
+///
+template<typename T>
+void check_type(const char *type, const char *str, unsigned len,
+                unsigned options, const NumberText &num) {
+  NumberRecognizer<> recognizer(str, len, options);
+  T value;
+  Status status = recognizer.read(value);
+  Outcome actual = make_outcome(value, status);
+  Outcome expected = reference<T>(
+    num, std::integral_constant<bool, std::numeric_limits<T>::is_integer>());
+  if (!(actual == expected))
+    report(str, len, options, type,
+           "got " + actual.str() + ", expected " + expected.str());
+}
+
+
+/// \brief Returns true if the text at the pointer is infinity or NaN, which
+/// are read by strtod but not by the recognizer.
+///
+bool is_special(const char *str) {
+  if (*str == '+' || *str == '-')
+    ++str;
+  return *str == 'i' || *str == 'I' || *str == 'n' || *str == 'N';
+}
+
+
+/// \brief Returns number of characters read by the standard function.
+///
+/// Decimal numbers and hexadecimal numbers, if hexadecimal float notation is
+/// allowed, are read by strtod.
+///
+size_t standard_length(const char *str, unsigned base, unsigned options) {
+  char *end;
+  errno = 0;
+  if (base == 10 || (base == 16 && (options & HexFloating)))
+    strtod(str, &end);
+  else
+    strtoll(str, &end, base);
+  return end - str;
+}
+
+
+/// \brief Checks that the recognizer finds the same number as the standard
+/// functions.
+///
+/// \returns True if the number is found.
+///
+bool check_syntax(const char *str, unsigned len, unsigned options,
+                  NumberText &num) {
+  NumberRecognizer<> recognizer(str, len, options);
+  recognizer.recognize();
+
+  // Copy of the input is terminated by null character.
+  std::string input(str, len);
+  const char *start = input.c_str() + recognizer.get_number_start();
+
+  if (recognizer.failure()) {
+    size_t read = standard_length(start, 10, options);
+    if (read && !is_special(start))
+      report(str, len, options, "syntax", "strtod reads " +
+             quote(start, read) + ", recognizer finds nothing");
+    return false;
+  }
+
+  num.text.assign(recognizer.begin_number(), recognizer.end_number());
+  num.base = recognizer.get_base();
+  num.is_float = recognizer.is_float();
+  num.is_negative = recognizer.is_negative();
+
+  // Number found by the recognizer must be read entirely.
+  size_t read = standard_length(num.text.c_str(), num.base, options);
+  if (read != num.text.size())
+    report(str, len, options, "syntax", "recognizer finds " +
+           quote(num.text.data(), num.text.size()) + ", standard function "
+           "reads " + quote(num.text.data(), read));
+
+  // Standard function must not find longer number. Hexadecimal numbers after
+  // zero are not checked if the prefix is not allowed.
+  char next = start[num.text.size()];
+  if (num.base == 10 && (next == 'x' || next == 'X'))
+    return true;
+  read = standard_length(start, num.base, options);
+  if (read != num.text.size())
+    report(str, len, options, "syntax", "recognizer finds " +
+           quote(num.text.data(), num.text.size()) + ", standard function "
+           "reads " + quote(start, read));
+  return true;
+}
+
+
+void check_input(const char *str, size_t size) {
+  unsigned len = static_cast<unsigned>(std::min(size, MaxInputLength));
+  for (unsigned options : CheckedOptions) {
+    NumberText num;
+    if (!check_syntax(str, len, options, num))
+      continue;
+    check_type<signed char>("signed char", str, len, options, num);
+    check_type<unsigned char>("unsigned char", str, len, options, num);
+    check_type<short>("short", str, len, options, num);
+    check_type<unsigned short>("unsigned short", str, len, options, num);
+    check_type<int>("int", str, len, options, num);
+    check_type<unsigned>("unsigned", str, len, options, num);
+    check_type<long>("long", str, len, options, num);
+    check_type<unsigned long>("unsigned long", str, len, options, num);
+    check_type<long long>("long long", str, len, options, num);
+    check_type<unsigned long long>("unsigned long long", str, len, options,
+                                   num);
+    check_type<float>("float", str, len, options, num);
+    check_type<double>("double", str, len, options, num);
+    check_type<long double>("long double", str, len, options, num);
+  }
+}
+
+}
+
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  abort_on_mismatch = true;
+  check_input(reinterpret_cast<const char *>(data), size);
+  return 0;
+}
+
+
+#if !defined(CONVERSION_LIBFUZZER)
+namespace {
+
+typedef std::vector<std::string> Corpus;
+
+
+/// \brief Pseudo-random generator (xorshift64*).
+///
+class Random {
+public:
+  explicit Random(uint64_t seed) : state(seed ? seed : 1) {}
+
+  uint64_t next() {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 2685821657736338717ULL;
+  }
+
+  /// \brief Returns number in range [0, n).
+  unsigned below(unsigned n) { return static_cast<unsigned>(next() % n); }
+
+  char digit() { return static_cast<char>('0' + below(10)); }
+
+private:
+  uint64_t state;
+};
+
+
+/// Texts near limits of integer and float types.
+const char *const BoundaryValues[] = {
+  "127", "128", "-128", "-129", "255", "256", "32767", "32768", "-32768",
+  "-32769", "65535", "65536", "2147483647", "2147483648", "-2147483648",
+  "-2147483649", "4294967295", "4294967296", "9223372036854775807",
+  "9223372036854775808", "-9223372036854775808", "-9223372036854775809",
+  "18446744073709551615", "18446744073709551616", "-18446744073709551616",
+  "0x7f", "0x80", "-0x80", "-0x81", "0xffff", "0x10000", "0x7fffffff",
+  "0x80000000", "0xffffffffffffffff", "0x10000000000000000",
+  "-0x8000000000000000", "-0x8000000000000001", "9007199254740993",
+  "9007199254740993.000000000000000000001", "1.7976931348623157e308",
+  "1.7976931348623158e308", "1.7976931348623159e308",
+  "2.2250738585072011e-308", "2.2250738585072014e-308",
+  "4.9406564584124654e-324", "2.4703282292062327e-324",
+  "2.4703282292062328e-324", "3.4028234663852886e38", "3.4028235677973366e38",
+  "1.1754943508222875e-38", "1.4012984643248171e-45",
+  "7.0064923216240854e-46", "0.1", "-0", "-0.0e-999", "1e-400", "1e400",
+  "0.000000000000000000000000000000000000000000001e-300", "1e99999999999",
+  "0x1.fffffffffffffp1023", "0x1.fffffffffffff8p1023", "0x1p1024",
+  "0x1p-1022", "0x0.fffffffffffffp-1022", "0x1p-1074", "0x1p-1075",
+  "0x1.0000000000001p-1075", "0x1.fffffep127", "0x1.ffffffp127", "0x1p-149",
+  "0x1p-150", "0x1.000001p-150", "0x1.00000000000008p0",
+  "0x1.000000000000080000000001p0", "0x7fffffffffffffffp0", "0x1p63",
+  "-0x1p63", "-0x1.0000000000001p63", "0x1p64", "0x.8p1", "-0x.0p99"
+};
+
+
+void append_digits(std::string &text, Random &random, unsigned count) {
+  for (unsigned i = 0; i < count; ++i)
+    text += random.digit();
+}
+
+
+/// \brief Generates number text with random parts.
+///
+std::string generate_number(Random &random) {
+  static const unsigned DigitCounts[] = {
+    0, 1, 1, 2, 3, 5, 8, 17, 18, 19, 20, 21, 40, 400
+  };
+  std::string text;
+  if (random.below(8) == 0)
+    text += random.below(2) ? " " : "\t";
+  static const char *const Signs[] = { "", "", "-", "+" };
+  text += Signs[random.below(4)];
+  if (random.below(8) == 0) {
+    text += random.below(2) ? "0x" : "0X";
+    unsigned count = 1 + random.below(20);
+    for (unsigned i = 0; i < count; ++i)
+      text += "0123456789abcdefABCDEF"[random.below(22)];
+    if (random.below(2)) {
+      text += '.';
+      count = random.below(20);
+      for (unsigned i = 0; i < count; ++i)
+        text += "0123456789abcdefABCDEF"[random.below(22)];
+    }
+    if (random.below(2)) {
+      text += random.below(2) ? 'p' : 'P';
+      text += Signs[random.below(4)];
+      append_digits(text, random, 1 + random.below(4));
+    }
+  } else {
+    if (random.below(4) == 0)
+      text.append(random.below(4), '0');
+    append_digits(text, random, DigitCounts[random.below(14)]);
+    if (random.below(2)) {
+      text += '.';
+      append_digits(text, random, DigitCounts[random.below(14)]);
+    }
+    if (random.below(3) == 0) {
+      text += random.below(2) ? 'e' : 'E';
+      text += Signs[random.below(4)];
+      append_digits(text, random, random.below(4) ? 1 + random.below(3)
+                                                  : random.below(12));
+    }
+  }
+  if (random.below(8) == 0)
+    text += ' ';
+  if (random.below(8) == 0)
+    text += ".eE+-xpz"[random.below(8)];
+  return text;
+}
+
+
+/// \brief Generates text of random value of type double.
+///
+std::string generate_double(Random &random) {
+  double value;
+  uint64_t bits = random.next();
+  memcpy(&value, &bits, sizeof(value));
+  if (!std::isfinite(value))
+    value = 1;
+  char buf[512];
+  switch (random.below(3)) {
+  case 0:
+    snprintf(buf, sizeof(buf), "%.*g", 1 + random.below(17), value);
+    break;
+  case 1:
+    snprintf(buf, sizeof(buf), "%.*e", random.below(25), value);
+    break;
+  default:
+    snprintf(buf, sizeof(buf), "%.*f", random.below(30),
+             std::ldexp(value, -std::ilogb(value) + random.below(80) - 40));
+    break;
+  }
+  return buf;
+}
+
+
+/// \brief Generates input for checking.
+///
+/// Inputs are numbers with random parts, values near type limits, random
+/// double values and random sequences of characters that occur in numbers.
+///
+std::string generate(Random &random) {
+  switch (random.below(4)) {
+  case 0:
+    return generate_number(random);
+  case 1: {
+    const unsigned count = sizeof(BoundaryValues) / sizeof(BoundaryValues[0]);
+    std::string text = BoundaryValues[random.below(count)];
+    if (random.below(4) == 0)
+      text[random.below(static_cast<unsigned>(text.size()))] = random.digit();
+    return text;
+  }
+  case 2:
+    return generate_double(random);
+  default: {
+    static const char Alphabet[] = "0123456789+-.eExX \tabcdfinpABCDF";
+    std::string text;
+    unsigned len = 1 + random.below(30);
+    for (unsigned i = 0; i < len; ++i)
+      text += Alphabet[random.below(sizeof(Alphabet) - 1)];
+    return text;
+  }
+  }
+}
+
+
+bool read_file(const std::filesystem::path &path, Corpus &corpus) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    return false;
+  std::ostringstream content;
+  content << in.rdbuf();
+  corpus.push_back(content.str());
+  return true;
+}
+
+
+bool read_inputs(const char *name, Corpus &corpus) {
+  std::error_code error;
+  if (!std::filesystem::is_directory(name, error))
+    return read_file(name, corpus);
+  std::vector<std::filesystem::path> files;
+  for (const auto &entry : std::filesystem::directory_iterator(name, error))
+    if (entry.is_regular_file())
+      files.push_back(entry.path());
+  if (error)
+    return false;
+  std::sort(files.begin(), files.end());
+  for (const auto &file : files)
+    if (!read_file(file, corpus))
+      return false;
+  return true;
+}
+
+
+template<typename T>
+double run_recognizer(const Corpus &corpus) {
+  double sum = 0;
+  for (const std::string &input : corpus) {
+    NumberRecognizer<> recognizer(input.data(),
+                                  static_cast<unsigned>(input.size()));
+    T value;
+    recognizer.read(value);
+    sum += static_cast<double>(value);
+  }
+  return sum;
+}
+
+double run_strtoll(const Corpus &corpus) {
+  double sum = 0;
+  for (const std::string &input : corpus)
+    sum += static_cast<double>(strtoll(input.c_str(), nullptr, 10));
+  return sum;
+}
+
+double run_strtof(const Corpus &corpus) {
+  double sum = 0;
+  for (const std::string &input : corpus)
+    sum += strtof(input.c_str(), nullptr);
+  return sum;
+}
+
+double run_strtod(const Corpus &corpus) {
+  double sum = 0;
+  for (const std::string &input : corpus)
+    sum += strtod(input.c_str(), nullptr);
+  return sum;
+}
+
+
+/// \brief Conversion path which throughput is reported.
+struct Path {
+  const char *name;
+  double (*run)(const Corpus &);
+};
+
+const Path paths[] = {
+  { "recognizer<int>", run_recognizer<int> },
+  { "recognizer<long long>", run_recognizer<long long> },
+  { "recognizer<float>", run_recognizer<float> },
+  { "recognizer<double>", run_recognizer<double> },
+  { "strtoll", run_strtoll },
+  { "strtof", run_strtof },
+  { "strtod", run_strtod },
+};
+
+
+/// Receives results of conversions, so that they are not optimized away.
+volatile double sink;
+
+
+/// \brief Prints time per input and throughput of each conversion path on the
+/// corpus. The best of several passes is reported.
+///
+void report_throughput(const Corpus &corpus) {
+  typedef std::chrono::steady_clock Clock;
+  const unsigned Passes = 5;
+  size_t bytes = 0;
+  for (const std::string &input : corpus)
+    bytes += input.size();
+  for (const Path &path : paths) {
+    double best = std::numeric_limits<double>::max();
+    for (unsigned pass = 0; pass < Passes; ++pass) {
+      Clock::time_point start = Clock::now();
+      sink = path.run(corpus);
+      double elapsed = std::chrono::duration<double, std::nano>(
+        Clock::now() - start).count();
+      best = std::min(best, elapsed);
+    }
+    printf("%-24s %8.1f ns/input %8.1f MB/s\n", path.name,
+           best / corpus.size(), bytes / best * 1000);
+  }
+}
+
+
+void usage() {
+  fprintf(stderr, "Usage: conversion_fuzz [--random N] [--seed S] "
+                  "[--no-timing] [FILE | DIRECTORY]...\n");
+}
+
+}
+
+
+int main(int argc, char *argv[]) {
+  unsigned long random_count = 0;
+  bool has_random_count = false;
+  uint64_t seed = 1;
+  bool timing = true;
+  Corpus corpus;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool has_value = i + 1 < argc;
+    if (arg == "--random" && has_value) {
+      random_count = strtoul(argv[++i], nullptr, 10);
+      has_random_count = true;
+    } else if (arg == "--seed" && has_value) {
+      seed = strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--no-timing") {
+      timing = false;
+    } else if (arg[0] == '-') {
+      usage();
+      return 1;
+    } else if (!read_inputs(argv[i], corpus)) {
+      fprintf(stderr, "Cannot read '%s'\n", argv[i]);
+      return 1;
+    }
+  }
+  if (!has_random_count && corpus.empty())
+    random_count = 100000;
+
+  Random random(seed);
+  for (unsigned long i = 0; i < random_count; ++i)
+    corpus.push_back(generate(random));
+
+  for (const std::string &input : corpus)
+    check_input(input.data(), input.size());
+  printf("%zu inputs checked, %lu mismatches\n", corpus.size(),
+         mismatch_count);
+
+  if (timing && !corpus.empty())
+    report_throughput(corpus);
+  return mismatch_count ? 1 : 0;
+}
+#endif
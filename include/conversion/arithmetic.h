@@ -0,0 +1,276 @@
+//===--- arithmetic.h -------------------------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Helpers for integer arithmetic used by conversion functions.
+///
+//===----------------------------------------------------------------------===//
+#ifndef CONVERSION_ARITHMETIC_H_
+#define CONVERSION_ARITHMETIC_H_
+
+//------ Dependencies ----------------------------------------------------------
+#include <limits>
+#include <type_traits>
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+//------------------------------------------------------------------------------
+
+// Check if compiler provides intrinsics for arithmetic with overflow check.
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_mul_overflow) && __has_builtin(__builtin_add_overflow)
+#define CONVERSION_HAS_OVERFLOW_BUILTINS 1
+#endif
+#elif defined(__GNUC__) && __GNUC__ >= 5
+#define CONVERSION_HAS_OVERFLOW_BUILTINS 1
+#endif
+
+// Check if compiler provides 128-bit integer types.
+#if defined(__SIZEOF_INT128__)
+#define CONVERSION_HAS_INT128 1
+#endif
+
+
+namespace conversion {
+
+namespace internal {
+
+/// \brief Powers of ten representable by 64-bit unsigned integer.
+///
+/// It is a template only to allow definition of the static data member in
+/// header file.
+///
+template<typename T = void>
+struct Power10Integers {
+  static constexpr uint64_t values[] = {
+    1ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+    10000000000ULL,
+    100000000000ULL,
+    1000000000000ULL,
+    10000000000000ULL,
+    100000000000000ULL,
+    1000000000000000ULL,
+    10000000000000000ULL,
+    100000000000000000ULL,
+    1000000000000000000ULL,
+    10000000000000000000ULL
+  };
+};
+
+template<typename T>
+constexpr uint64_t Power10Integers<T>::values[];
+
+
+/// \brief Unsigned integer type of the same width as the given one.
+///
+/// Unlike std::make_unsigned, it also maps 128-bit integer types, which the
+/// standard library recognizes only in GNU dialects of C++.
+///
+template<typename IntType>
+struct make_unsigned : public std::make_unsigned<IntType> {};
+
+#ifdef CONVERSION_HAS_INT128
+template<>
+struct make_unsigned<__int128> {
+  typedef unsigned __int128 type;
+};
+
+template<>
+struct make_unsigned<unsigned __int128> {
+  typedef unsigned __int128 type;
+};
+#endif
+
+
+/// \brief Calculates full 128-bit product of two 64-bit numbers.
+///
+/// \param[in]  a, b  Multiplied numbers.
+/// \param[out] high  Upper 64 bits of the product.
+///
+/// \returns Lower 64 bits of the product.
+///
+inline uint64_t multiply_128(uint64_t a, uint64_t b, uint64_t &high) {
+#if defined(__SIZEOF_INT128__)
+  unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+  high = static_cast<uint64_t>(product >> 64);
+  return static_cast<uint64_t>(product);
+#else
+  uint64_t a_lo = static_cast<uint32_t>(a), a_hi = a >> 32;
+  uint64_t b_lo = static_cast<uint32_t>(b), b_hi = b >> 32;
+  uint64_t lo_lo = a_lo * b_lo;
+  uint64_t hi_lo = a_hi * b_lo;
+  uint64_t lo_hi = a_lo * b_hi;
+  uint64_t hi_hi = a_hi * b_hi;
+  uint64_t cross = (lo_lo >> 32) + static_cast<uint32_t>(hi_lo) + lo_hi;
+  high = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+  return (cross << 32) | static_cast<uint32_t>(lo_lo);
+#endif
+}
+
+
+/// \brief Returns number of leading zero bits in nonzero 64-bit value.
+///
+inline int leading_zeros(uint64_t x) {
+  assert(x != 0);
+#if defined(__GNUC__)
+  return __builtin_clzll(x);
+#else
+  int n = 0;
+  for (uint64_t mask = uint64_t(1) << 63; (x & mask) == 0; mask >>= 1)
+    ++n;
+  return n;
+#endif
+}
+
+
+
+/// \brief Returns number of significant bits in nonzero 64-bit value.
+///
+inline int bit_length(uint64_t x) {
+  return 64 - leading_zeros(x);
+}
+
+
+/// \brief Calculates a * b + c, where all arguments are nonnegative.
+///
+/// \param[out] result Result of calculation, valid if there is no overflow.
+///
+/// \returns True if the result does not fit type T.
+///
+template<typename T>
+bool multiply_add_overflow(T a, T b, T c, T &result) {
+#ifdef CONVERSION_HAS_OVERFLOW_BUILTINS
+  T product;
+  bool overflow = __builtin_mul_overflow(a, b, &product);
+  return __builtin_add_overflow(product, c, &result) || overflow;
+#else
+  assert(a >= 0 && b > 0 && c >= 0);
+  if (a > (std::numeric_limits<T>::max() - c) / b)
+    return true;
+  result = static_cast<T>(a * b + c);
+  return false;
+#endif
+}
+
+
+/// \brief Loads eight bytes from unaligned memory, so that the first byte
+/// becomes the lowest byte of the result.
+///
+inline uint64_t load_eight_bytes(const void *ptr) {
+  uint64_t result;
+  memcpy(&result, ptr, sizeof(result));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  result = __builtin_bswap64(result);
+#endif
+  return result;
+}
+
+
+/// \brief Checks if all eight bytes loaded by load_eight_bytes are ASCII
+/// decimal digits.
+///
+/// Digits are 0x30..0x39, so upper nibble of each byte must be 3 and adding 6
+/// to the lower nibble must not produce carry into the upper one.
+///
+inline bool is_eight_digits(uint64_t chars) {
+  return ((chars & 0xF0F0F0F0F0F0F0F0ULL) |
+          (((chars + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4))
+         == 0x3333333333333333ULL;
+}
+
+
+/// \brief Converts eight ASCII decimal digits into the corresponding number.
+///
+/// \param chars Digits as loaded by load_eight_bytes, first digit is the most
+///              significant.
+///
+/// Pairs of adjacent digits are combined first, then pairs of pairs, then the
+/// two four-digit halves, three multiplications in total.
+///
+inline uint32_t parse_eight_digits(uint64_t chars) {
+  const uint64_t mask = 0x000000FF000000FFULL;
+  const uint64_t mul1 = 100 + (1000000ULL << 32);
+  const uint64_t mul2 = 1 + (10000ULL << 32);
+  chars -= 0x3030303030303030ULL;
+  chars = chars * 10 + (chars >> 8);
+  chars = ((chars & mask) * mul1 + ((chars >> 16) & mask) * mul2) >> 32;
+  return static_cast<uint32_t>(chars);
+}
+
+
+/// \brief Checks if all eight bytes loaded by load_eight_bytes are ASCII
+/// hexadecimal digits.
+///
+/// For a byte below 0x80, adding 0x80 - low sets its high bit if the byte is
+/// not less than low, and adding 0x7F - high sets it if the byte exceeds high.
+/// Setting bit 0x20 maps capital letters to small ones and cannot turn any
+/// other character into a small letter.
+///
+inline bool is_eight_hex_digits(uint64_t chars) {
+  const uint64_t ones = 0x0101010101010101ULL;
+  const uint64_t high = 0x8080808080808080ULL;
+  uint64_t lower = chars | (0x20 * ones);
+  uint64_t digit = (chars + (0x80 - '0') * ones) &
+                   ~(chars + (0x7F - '9') * ones);
+  uint64_t alpha = (lower + (0x80 - 'a') * ones) &
+                   ~(lower + (0x7F - 'f') * ones);
+  return (chars & high) == 0 && ((digit | alpha) & high) == high;
+}
+
+
+/// \brief Converts eight ASCII hexadecimal digits into the corresponding
+/// number.
+///
+/// \param chars Digits as loaded by load_eight_bytes and checked by
+///              is_eight_hex_digits, first digit is the most significant.
+///
+/// Letters have bit 0x40 set, their lower nibble is less than the value by 9.
+/// Nibbles are then gathered by shifts: pairs into bytes, bytes into 16-bit
+/// words and words into the result.
+///
+inline uint32_t parse_eight_hex_digits(uint64_t chars) {
+  uint64_t nibbles = (chars & 0x0F0F0F0F0F0F0F0FULL) +
+                     ((chars >> 6) & 0x0101010101010101ULL) * 9;
+  nibbles = ((nibbles << 4) | (nibbles >> 8)) & 0x00FF00FF00FF00FFULL;
+  nibbles = ((nibbles << 8) | (nibbles >> 16)) & 0x0000FFFF0000FFFFULL;
+  return static_cast<uint32_t>((nibbles << 16) | (nibbles >> 32));
+}
+
+}
+}
+#endif
@@ -0,0 +1,197 @@
+//===--- big_integer.h ------------------------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Unsigned integer of limited but large size, used for exact comparisons of
+/// decimal and binary numbers.
+///
+//===----------------------------------------------------------------------===//
+#ifndef CONVERSION_BIG_INTEGER_H_
+#define CONVERSION_BIG_INTEGER_H_
+
+//------ Dependencies ----------------------------------------------------------
+#include "arithmetic.h"
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+//------------------------------------------------------------------------------
+
+
+namespace conversion {
+
+namespace internal {
+
+/// \brief Unsigned integer which has fixed capacity and is stored entirely in
+/// the object, so it does not allocate memory.
+///
+/// Capacity of 4000 bits is enough to represent 10^(769+342), the largest
+/// number required for correct rounding of decimal numbers to double.
+///
+/// Operations that would exceed the capacity return false and leave the value
+/// in undefined state.
+///
+class BigInteger {
+public:
+  static const unsigned MaxBits = 4000;
+  static const unsigned MaxLimbs = (MaxBits + 63) / 64;
+
+  BigInteger() : size(0) {}
+  explicit BigInteger(uint64_t x) : size(0) {
+    if (x)
+      limbs[size++] = x;
+  }
+
+  bool is_zero() const { return size == 0; }
+
+  /// \brief Returns number of significant bits.
+  unsigned bit_length() const {
+    if (size == 0)
+      return 0;
+    return 64 * size - leading_zeros(limbs[size - 1]);
+  }
+
+  /// \brief Returns 64 most significant bits, normalized so that the highest
+  /// bit is set.
+  ///
+  /// \param[out] truncated Set to true if any of the remaining bits is set.
+  ///
+  uint64_t high64(bool &truncated) const {
+    truncated = false;
+    if (size == 0)
+      return 0;
+    unsigned lz = leading_zeros(limbs[size - 1]);
+    uint64_t result = limbs[size - 1] << lz;
+    if (size > 1) {
+      if (lz)
+        result |= limbs[size - 2] >> (64 - lz);
+      truncated = (limbs[size - 2] << lz) != 0;
+      for (unsigned i = 0; !truncated && i + 2 < size; ++i)
+        truncated = limbs[i] != 0;
+    }
+    return result;
+  }
+
+  /// \brief Compares this number with the given one.
+  ///
+  /// \returns Positive value if this number is larger, negative if it is
+  /// smaller, and zero if they are equal.
+  ///
+  int compare(const BigInteger &x) const {
+    if (size != x.size)
+      return size > x.size ? 1 : -1;
+    for (unsigned i = size; i > 0; --i) {
+      if (limbs[i - 1] != x.limbs[i - 1])
+        return limbs[i - 1] > x.limbs[i - 1] ? 1 : -1;
+    }
+    return 0;
+  }
+
+  /// \brief Calculates this * y + z.
+  bool multiply_add(uint64_t y, uint64_t z) {
+    uint64_t carry = z;
+    for (unsigned i = 0; i < size; ++i) {
+      uint64_t high;
+      uint64_t low = multiply_128(limbs[i], y, high);
+      low += carry;
+      high += low < carry;
+      limbs[i] = low;
+      carry = high;
+    }
+    if (carry)
+      return push(carry);
+    return true;
+  }
+
+  /// \brief Multiplies the number by 2^n.
+  bool shift_left(unsigned n) {
+    if (size == 0)
+      return true;
+    unsigned limb_shift = n / 64;
+    unsigned bit_shift = n % 64;
+    if (bit_shift) {
+      uint64_t carry = 0;
+      for (unsigned i = 0; i < size; ++i) {
+        uint64_t next = limbs[i] >> (64 - bit_shift);
+        limbs[i] = (limbs[i] << bit_shift) | carry;
+        carry = next;
+      }
+      if (carry && !push(carry))
+        return false;
+    }
+    if (limb_shift) {
+      if (size + limb_shift > MaxLimbs)
+        return false;
+      memmove(limbs + limb_shift, limbs, size * sizeof(limbs[0]));
+      memset(limbs, 0, limb_shift * sizeof(limbs[0]));
+      size += limb_shift;
+    }
+    return true;
+  }
+
+  /// \brief Multiplies the number by 5^n.
+  bool multiply_pow5(unsigned n) {
+    // 5^27 is the largest power of five that fits 64 bits.
+    const unsigned MaxSmallPower = 27;
+    static const uint64_t small_powers[MaxSmallPower + 1] = {
+      1ULL, 5ULL, 25ULL, 125ULL, 625ULL, 3125ULL, 15625ULL, 78125ULL,
+      390625ULL, 1953125ULL, 9765625ULL, 48828125ULL, 244140625ULL,
+      1220703125ULL, 6103515625ULL, 30517578125ULL, 152587890625ULL,
+      762939453125ULL, 3814697265625ULL, 19073486328125ULL,
+      95367431640625ULL, 476837158203125ULL, 2384185791015625ULL,
+      11920928955078125ULL, 59604644775390625ULL, 298023223876953125ULL,
+      1490116119384765625ULL, 7450580596923828125ULL
+    };
+    for (; n >= MaxSmallPower; n -= MaxSmallPower)
+      if (!multiply_add(small_powers[MaxSmallPower], 0))
+        return false;
+    if (n)
+      return multiply_add(small_powers[n], 0);
+    return true;
+  }
+
+  /// \brief Multiplies the number by 10^n.
+  bool multiply_pow10(unsigned n) {
+    return multiply_pow5(n) && shift_left(n);
+  }
+
+private:
+  uint64_t limbs[MaxLimbs];   ///< Little-endian sequence of 64-bit words
+  unsigned size;              ///< Number of used limbs
+
+  bool push(uint64_t x) {
+    if (size == MaxLimbs)
+      return false;
+    limbs[size++] = x;
+    return true;
+  }
+};
+
+}
+}
+#endif
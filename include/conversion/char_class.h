@@ -0,0 +1,189 @@
+//===--- char_class.h -------------------------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Classification of characters that may constitute a number.
+///
+/// Classification does not depend on current locale, the character classes
+/// are those of the "C" locale. Information about a character is obtained by
+/// single lookup in a constant table, characters with codes above 255 do not
+/// belong to any class.
+///
+//===----------------------------------------------------------------------===//
+#ifndef CONVERSION_CHAR_CLASS_H_
+#define CONVERSION_CHAR_CLASS_H_
+
+//------ Dependencies ----------------------------------------------------------
+#include <type_traits>
+//------------------------------------------------------------------------------
+
+
+namespace conversion {
+
+namespace internal {
+
+/// Character class flags.
+enum CharClass : unsigned char {
+  SpaceClass    = 0x01,   ///< Whitespace: space, \\t, \\n, \\v, \\f, \\r
+  DecimalClass  = 0x02,   ///< Decimal digit
+  HexClass      = 0x04,   ///< Hexadecimal digit
+  SignClass     = 0x08,   ///< Sign: + or -
+  ExponentClass = 0x10,   ///< Exponent marker: e or E
+  DotClass      = 0x20    ///< Decimal point
+};
+
+
+/// Digit value of characters that are not digits in any base.
+const unsigned char NotDigit = 0xFF;
+
+
+/// Information about a character.
+struct CharInfo {
+  unsigned char digit;    ///< Digit value in bases up to 36, or NotDigit
+  unsigned char flags;    ///< Combination of CharClass flags
+};
+
+
+/// \brief Builds information record for the character with the given code.
+///
+constexpr CharInfo make_char_info(unsigned code) {
+  CharInfo info = { NotDigit, 0 };
+  if (code >= '0' && code <= '9') {
+    info.digit = static_cast<unsigned char>(code - '0');
+    info.flags = DecimalClass | HexClass;
+  } else if (code >= 'A' && code <= 'Z') {
+    info.digit = static_cast<unsigned char>(code - 'A' + 10);
+    if (code <= 'F')
+      info.flags = HexClass;
+    if (code == 'E')
+      info.flags |= ExponentClass;
+  } else if (code >= 'a' && code <= 'z') {
+    info.digit = static_cast<unsigned char>(code - 'a' + 10);
+    if (code <= 'f')
+      info.flags = HexClass;
+    if (code == 'e')
+      info.flags |= ExponentClass;
+  } else if (code == ' ' || (code >= '\t' && code <= '\r')) {
+    info.flags = SpaceClass;
+  } else if (code == '+' || code == '-') {
+    info.flags = SignClass;
+  } else if (code == '.') {
+    info.flags = DotClass;
+  }
+  return info;
+}
+
+
+/// Table of information records for characters with codes 0..255.
+struct CharTableData {
+  CharInfo entries[256];
+};
+
+constexpr CharTableData make_char_table() {
+  CharTableData table = {};
+  for (unsigned code = 0; code < 256; ++code)
+    table.entries[code] = make_char_info(code);
+  return table;
+}
+
+
+/// \brief Holder of the character table.
+///
+/// The class is a template, so that the table may be defined in header.
+///
+template<typename T = void>
+struct CharTable {
+  static constexpr CharTableData table = make_char_table();
+};
+
+template<typename T>
+constexpr CharTableData CharTable<T>::table;
+
+static_assert(CharTable<>::table.entries['7'].digit == 7, "invalid table");
+static_assert(CharTable<>::table.entries['z'].digit == 35, "invalid table");
+static_assert(CharTable<>::table.entries['/'].digit == NotDigit,
+              "invalid table");
+static_assert(CharTable<>::table.entries[0xB7].flags == 0, "invalid table");
+
+
+/// \brief Returns information about the character.
+///
+template<typename CharT>
+CharInfo char_info(CharT ch) {
+  typedef typename std::make_unsigned<CharT>::type UCharT;
+  UCharT code = static_cast<UCharT>(ch);
+  if (sizeof(CharT) > 1 && code > 0xFF)
+    return CharInfo{ NotDigit, 0 };
+  return CharTable<>::table.entries[code];
+}
+
+
+/// \brief Returns value of a digit in bases up to 36.
+///
+/// If the character is not a digit, returned value is larger than any base.
+///
+template<typename CharT>
+unsigned char digit_value(CharT ch) {
+  return char_info(ch).digit;
+}
+
+
+template<typename CharT>
+bool is_space_char(CharT ch) {
+  return (char_info(ch).flags & SpaceClass) != 0;
+}
+
+template<typename CharT>
+bool is_decimal_char(CharT ch) {
+  return (char_info(ch).flags & DecimalClass) != 0;
+}
+
+template<typename CharT>
+bool is_hex_char(CharT ch) {
+  return (char_info(ch).flags & HexClass) != 0;
+}
+
+template<typename CharT>
+bool is_sign_char(CharT ch) {
+  return (char_info(ch).flags & SignClass) != 0;
+}
+
+template<typename CharT>
+bool is_exponent_char(CharT ch) {
+  return (char_info(ch).flags & ExponentClass) != 0;
+}
+
+template<typename CharT>
+bool is_binary_exponent_char(CharT ch) {
+  return ch == CharT('p') || ch == CharT('P');
+}
+
+}
+}
+#endif
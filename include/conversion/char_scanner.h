@@ -0,0 +1,117 @@
+//===--- char_scanner.h -----------------------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Scanning of character runs that make up parts of a number.
+///
+/// Runs of whitespace and decimal digits in narrow strings are scanned by
+/// vectorized code when the processor supports it. The implementation is
+/// chosen at run time according to the instruction set level, see
+/// cpu_dispatch.h. Groups of sixteen hexadecimal digits are converted to
+/// numbers in the same way.
+///
+//===----------------------------------------------------------------------===//
+#ifndef CONVERSION_CHAR_SCANNER_H_
+#define CONVERSION_CHAR_SCANNER_H_
+
+//------ Dependencies ----------------------------------------------------------
+#include "char_class.h"
+#include <stdint.h>
+//------------------------------------------------------------------------------
+
+
+namespace conversion {
+
+namespace internal {
+
+/// \brief Scans whitespace run in a narrow string using the best
+/// implementation for current instruction set level.
+///
+const char *scan_spaces_vector(const char *cursor, const char *end);
+
+/// \brief Scans decimal digit run in a narrow string using the best
+/// implementation for current instruction set level.
+///
+const char *scan_digits_vector(const char *cursor, const char *end);
+
+/// \brief Converts sixteen hexadecimal digits of a narrow string into 64-bit
+/// number using the best implementation for current instruction set level.
+///
+/// \param[in]  str   Start of the digits, at least sixteen characters must be
+///                   readable.
+/// \param[out] value Receives the number, first digit is the most significant.
+///
+/// \returns False if some of the characters is not a hexadecimal digit, value
+///          is unspecified in this case.
+///
+bool parse_sixteen_hex_digits(const char *str, uint64_t &value);
+
+
+/// Minimal length of text for which vectorized scanner is used.
+const long MinVectorScanLength = 16;
+
+
+/// \brief Finds end of the whitespace run that starts at the cursor.
+///
+/// \returns Pointer to the first character that is not a whitespace, or end.
+///
+template<typename CharT>
+const CharT *scan_spaces(const CharT *cursor, const CharT *end) {
+  while (cursor != end && is_space_char(*cursor))
+    ++cursor;
+  return cursor;
+}
+
+inline const char *scan_spaces(const char *cursor, const char *end) {
+  if (end - cursor < MinVectorScanLength || !is_space_char(*cursor))
+    return scan_spaces<char>(cursor, end);
+  return scan_spaces_vector(cursor, end);
+}
+
+
+/// \brief Finds end of the decimal digit run that starts at the cursor.
+///
+/// \returns Pointer to the first character that is not a digit, or end.
+///
+template<typename CharT>
+const CharT *scan_digits(const CharT *cursor, const CharT *end) {
+  while (cursor != end && is_decimal_char(*cursor))
+    ++cursor;
+  return cursor;
+}
+
+inline const char *scan_digits(const char *cursor, const char *end) {
+  if (end - cursor < MinVectorScanLength)
+    return scan_digits<char>(cursor, end);
+  return scan_digits_vector(cursor, end);
+}
+
+}
+}
+#endif
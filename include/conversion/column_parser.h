@@ -0,0 +1,226 @@
+//===--- column_parser.h ----------------------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Conversion of arrays of strings into arrays of numbers.
+///
+/// Functions of this file convert many numbers of the same type in one call.
+/// Single recognizer is reused for all elements and status of each element is
+/// stored in separate array, so that the caller does not need to construct
+/// recognizer and check result for each number.
+///
+//===----------------------------------------------------------------------===//
+#ifndef CONVERSION_COLUMN_PARSER_H_
+#define CONVERSION_COLUMN_PARSER_H_
+
+//------ Dependencies ----------------------------------------------------------
+#include "number_recognizer.h"
+#include <stddef.h>
+#include <string>
+#include <tuple>
+//------------------------------------------------------------------------------
+
+
+namespace conversion {
+
+namespace internal {
+
+/// \brief Returns pointer to characters of a text represented by an object
+/// that has methods \c data and \c size, like std::string or string_view.
+///
+template<typename TextT>
+auto text_data(const TextT &text) -> decltype(text.data()) {
+  return text.data();
+}
+
+template<typename TextT>
+size_t text_size(const TextT &text) {
+  return text.size();
+}
+
+template<typename CharT>
+const CharT *text_data(const std::tuple<const CharT *, unsigned> &text) {
+  return std::get<0>(text);
+}
+
+template<typename CharT>
+unsigned text_size(const std::tuple<const CharT *, unsigned> &text) {
+  return std::get<1>(text);
+}
+
+
+/// \brief Converts single element of a column.
+///
+/// The element must entirely be a number, otherwise the status is NaN and the
+/// value is zero. Positive value equal to the magnitude of the negative limit
+/// is reported as overflow, as the stored value is clamped. Recognizer keeps
+/// text length as unsigned, so longer element is not a number either.
+///
+template<typename NumType, typename RecognizerT, typename CharT>
+Status parse_element(RecognizerT &recog, const CharT *text, size_t len,
+                     NumType &value) {
+  if (len > std::numeric_limits<unsigned>::max()) {
+    value = 0;
+    return NaN;
+  }
+  recog.init(text, static_cast<unsigned>(len));
+  Status st = recog.read(value);
+  if (!recog.success()) {
+    value = 0;
+    st = NaN;
+  } else if (st == NegativeLimit) {
+    st = IntOverflow;
+  }
+  return st;
+}
+
+
+/// \brief Converts array of texts using the specified recognizer.
+///
+template<typename NumType, typename RecognizerT, typename TextT>
+size_t parse_column(RecognizerT &recog, const TextT *in, size_t n,
+                    NumType *out, Status *st) {
+  size_t ok_count = 0;
+  for (size_t i = 0; i < n; ++i) {
+    Status res = parse_element(recog, text_data(in[i]), text_size(in[i]),
+                               out[i]);
+    if (st)
+      st[i] = res;
+    ok_count += res < OkCodes;
+  }
+  return ok_count;
+}
+
+
+/// \brief Converts fields of delimited buffer using the specified recognizer.
+///
+template<typename NumType, typename RecognizerT, typename CharT>
+size_t parse_delimited(RecognizerT &recog, const CharT *buf, size_t len,
+                       CharT delim, NumType *out, Status *st,
+                       size_t max_count) {
+  typedef std::char_traits<CharT> TraitT;
+  const CharT *end = buf + len;
+  size_t count = 0;
+  while (buf != end && count < max_count) {
+    const CharT *field_end = TraitT::find(buf, end - buf, delim);
+    if (!field_end)
+      field_end = end;
+    Status res = parse_element(recog, buf, size_t(field_end - buf),
+                               out[count]);
+    if (st)
+      st[count] = res;
+    ++count;
+    if (field_end == end)
+      break;
+    buf = field_end + 1;
+  }
+  return count;
+}
+
+}
+
+
+/// \brief Converts array of texts into array of numbers.
+///
+/// \tparam NumType Type of the numbers.
+/// \tparam TextT   Type of a text, it is either std::tuple<const CharT *,
+///                 unsigned> or a class with methods \c data and \c size,
+///                 like std::string or string_view.
+/// \param in   Input texts.
+/// \param n    Number of elements in the input and output arrays.
+/// \param out  Output array, receives converted values.
+/// \param st   Output array, receives status of each conversion. May be null.
+/// \param opts Recognizer options.
+///
+/// Each text must contain only a number, optionally surrounded by whitespace.
+/// If it is not so, the status of the element is NaN and the value is zero.
+///
+/// \returns Number of elements converted without error.
+///
+template<typename NumType, typename TextT>
+size_t parse_column(const TextT *in, size_t n, NumType *out, Status *st,
+                    unsigned opts = DefaultOptions) {
+  typedef typename std::remove_cv<typename std::remove_pointer<
+    decltype(internal::text_data(*in))>::type>::type CharT;
+  if (opts == DefaultOptions) {
+    StaticNumberRecognizer<DefaultOptions, 0, CharT> recog;
+    return internal::parse_column(recog, in, n, out, st);
+  }
+  NumberRecognizer<CharT> recog(opts);
+  return internal::parse_column(recog, in, n, out, st);
+}
+
+
+/// \brief Converts fields of a buffer separated by delimiter into array of
+/// numbers.
+///
+/// \param buf       Buffer with texts of numbers.
+/// \param len       Buffer length.
+/// \param delim     Character that separates fields.
+/// \param out       Output array, receives converted values.
+/// \param st        Output array, receives status of each conversion. May be
+///                  null.
+/// \param max_count Size of the output arrays.
+/// \param opts      Recognizer options.
+///
+/// Delimiter at the end of the buffer does not start a new field. Fields are
+/// converted as in parse_column.
+///
+/// \returns Number of fields stored into output arrays.
+///
+template<typename NumType, typename CharT>
+size_t parse_delimited(const CharT *buf, size_t len, CharT delim,
+                       NumType *out, Status *st, size_t max_count,
+                       unsigned opts = DefaultOptions) {
+  if (opts == DefaultOptions) {
+    StaticNumberRecognizer<DefaultOptions, 0, CharT> recog;
+    return internal::parse_delimited(recog, buf, len, delim, out, st,
+                                     max_count);
+  }
+  NumberRecognizer<CharT> recog(opts);
+  return internal::parse_delimited(recog, buf, len, delim, out, st,
+                                   max_count);
+}
+
+
+/// \brief Returns number of fields in the buffer as they are determined by
+/// parse_delimited.
+///
+template<typename CharT>
+size_t count_fields(const CharT *buf, size_t len, CharT delim) {
+  if (len == 0)
+    return 0;
+  size_t count = 1;
+  for (size_t i = 0; i + 1 < len; ++i)
+    count += buf[i] == delim;
+  return count;
+}
+
+}
+#endif
@@ -0,0 +1,127 @@
+//===--- cpu_dispatch.h -----------------------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Selection of vectorized code at run time.
+///
+/// Kernels that have vectorized implementations are compiled for several
+/// instruction set levels. The level supported by the processor is determined
+/// once, at program startup, and each kernel uses the best implementation
+/// available for it. The level may be lowered, which is useful for testing and
+/// benchmarking of the implementations.
+///
+//===----------------------------------------------------------------------===//
+#ifndef CONVERSION_CPU_DISPATCH_H_
+#define CONVERSION_CPU_DISPATCH_H_
+
+
+namespace conversion {
+
+/// Instruction set levels. Each level includes the previous ones.
+enum CpuLevel {
+  ScalarLevel,      ///< Portable code only
+  SSE2Level,        ///< SSE2, baseline of x86-64
+  SSE42Level,       ///< SSE4.2
+  AVX2Level,        ///< AVX2
+  AVX512Level,      ///< AVX-512 Foundation and Byte/Word instructions
+  CpuLevelCount     ///< Number of levels
+};
+
+
+/// \brief Returns the highest level supported by the processor and operating
+/// system.
+///
+CpuLevel detect_cpu_level();
+
+/// \brief Returns the level which kernels currently use.
+///
+/// By default it is the level detected at startup.
+///
+CpuLevel get_cpu_level();
+
+/// \brief Makes kernels use implementations not higher than the specified
+/// level.
+///
+/// \returns False if the level is not supported by the processor, current
+///          level is not changed in this case.
+///
+bool set_cpu_level(CpuLevel level);
+
+/// \brief Restores the level detected at startup.
+///
+void reset_cpu_level();
+
+/// \brief Returns the name of the level, like "avx2".
+///
+const char *get_cpu_level_name(CpuLevel level);
+
+
+namespace internal {
+
+/// \brief Set of implementations of a kernel for different instruction set
+/// levels.
+///
+/// \tparam FuncT Pointer to function type.
+///
+/// Implementation for scalar level is mandatory, others may be null if the
+/// kernel has no special code for the level or it cannot be compiled for the
+/// target. Implementation of the highest level that does not exceed the
+/// current one is used.
+///
+/// Constructor is constexpr, so kernels defined at namespace scope are
+/// initialized before any code runs and may be used by static constructors.
+///
+template<typename FuncT>
+class Kernel {
+public:
+  constexpr Kernel(FuncT scalar, FuncT sse2 = nullptr, FuncT sse42 = nullptr,
+                   FuncT avx2 = nullptr, FuncT avx512 = nullptr)
+    : selected() {
+    const FuncT impls[CpuLevelCount] = { scalar, sse2, sse42, avx2, avx512 };
+    FuncT best = scalar;
+    for (unsigned level = 0; level < CpuLevelCount; ++level) {
+      if (impls[level])
+        best = impls[level];
+      selected[level] = best;
+    }
+  }
+
+  /// \brief Returns the implementation for the specified level.
+  FuncT get(CpuLevel level) const { return selected[level]; }
+
+  /// \brief Returns the implementation for current level.
+  FuncT get() const { return selected[get_cpu_level()]; }
+
+private:
+  FuncT selected[CpuLevelCount];
+};
+
+}
+}
+#endif
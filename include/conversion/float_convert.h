@@ -0,0 +1,790 @@
+//===--- float_convert.h ----------------------------------------*- C++ -*-===//
+//
+// Copyright(c) 2016-2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Conversion of decimal digit sequences into binary floating point numbers.
+///
+/// The conversion does not use C library and does not allocate memory. Result
+/// is correctly rounded (round-half-to-even), so it is identical to the value
+/// obtained from \c strtod or \c strtof. Numbers in hexadecimal float notation
+/// are converted by assembling their bits directly.
+///
+//===----------------------------------------------------------------------===//
+#ifndef CONVERSION_FLOAT_CONVERT_H_
+#define CONVERSION_FLOAT_CONVERT_H_
+
+//------ Dependencies ----------------------------------------------------------
+#include "big_integer.h"
+#include "char_class.h"
+#include "number_convert.h"   // for error codes
+#include "power5_table.h"
+#include <limits>
+#include <tuple>
+#include <assert.h>
+#include <float.h>
+#include <stdint.h>
+#include <string.h>
+//------------------------------------------------------------------------------
+
+
+namespace conversion {
+
+namespace internal {
+
+/// \brief Describes binary representation of a floating point type.
+///
+/// \tparam FloatT Floating point type, float or double.
+///
+template<typename FloatT>
+struct BinaryFormat;
+
+template<>
+struct BinaryFormat<double> {
+  typedef uint64_t bits_type;
+  static const int mantissa_bits = 52;      ///< Explicitly stored bits
+  static const int exponent_bias = 1023;
+  static const int infinite_power = 0x7FF;  ///< Biased exponent of infinity
+  static const int max_exact_exponent10 = 22;
+  static const int max_digits = 769;        ///< Digits needed for rounding
+  static const int min_power10 = -342;      ///< Smaller powers produce zero
+  static const int max_power10 = 308;       ///< Larger powers produce infinity
+  static const int min_round_to_even = -4;  ///< Range of powers in which ties
+  static const int max_round_to_even = 23;  ///< are possible
+
+  /// Exact powers of ten representable by the type.
+  static double exact_power10(unsigned n) {
+    static const double powers[] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    assert(n <= max_exact_exponent10);
+    return powers[n];
+  }
+};
+
+template<>
+struct BinaryFormat<float> {
+  typedef uint32_t bits_type;
+  static const int mantissa_bits = 23;
+  static const int exponent_bias = 127;
+  static const int infinite_power = 0xFF;
+  static const int max_exact_exponent10 = 10;
+  static const int max_digits = 114;
+  static const int min_power10 = -64;
+  static const int max_power10 = 38;
+  static const int min_round_to_even = -17;
+  static const int max_round_to_even = 10;
+
+  static float exact_power10(unsigned n) {
+    static const float powers[] = {
+      1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+    };
+    assert(n <= max_exact_exponent10);
+    return powers[n];
+  }
+};
+
+
+/// \brief Assembles floating point value from its binary parts.
+///
+/// \param mantissa Mantissa without implicit leading bit.
+/// \param power2   Biased binary exponent.
+/// \param negative True if the number is negative.
+///
+template<typename FloatT>
+FloatT assemble_float(uint64_t mantissa, int power2, bool negative) {
+  typedef BinaryFormat<FloatT> Format;
+  typedef typename Format::bits_type bits_type;
+  bits_type bits = static_cast<bits_type>(mantissa)
+                 | (static_cast<bits_type>(power2) << Format::mantissa_bits);
+  if (negative)
+    bits |= bits_type(1) << (sizeof(bits_type) * 8 - 1);
+  FloatT result;
+  static_assert(sizeof(result) == sizeof(bits), "Unexpected float size");
+  memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+
+/// \brief Sets the value returned when the number is too large for the type.
+///
+template<typename FloatT>
+Status set_float_overflow(FloatT &value, bool negative) {
+  if (negative) {
+    value = -std::numeric_limits<FloatT>::max();
+    return DoubleOverflowNegative;
+  }
+  value = std::numeric_limits<FloatT>::max();
+  return DoubleOverflow;
+}
+
+
+/// \brief Binary floating point number as mantissa and biased exponent.
+///
+struct BinaryFloat {
+  uint64_t mantissa;  ///< Mantissa without implicit leading bit
+  int power2;         ///< Biased exponent
+
+  bool operator == (const BinaryFloat &x) const {
+    return mantissa == x.mantissa && power2 == x.power2;
+  }
+  bool operator != (const BinaryFloat &x) const { return !(*this == x); }
+};
+
+
+/// \brief Returns binary exponent of 10^q, that is floor(q * log2(10)) + 63.
+///
+inline int power10_exp2(int q) {
+  return (((152170 + 65536) * q) >> 16) + 63;
+}
+
+
+/// \brief Multiplies normalized mantissa by 128-bit approximation of 5^q.
+///
+/// \param[in]  q     Decimal exponent.
+/// \param[in]  w     Normalized decimal mantissa, its highest bit is set.
+/// \param[out] high  Upper 64 bits of the product.
+///
+/// \returns Lower 64 bits of the product.
+///
+/// We need mantissa_bits + 3 bits of the product: implicit bit, rounding bit
+/// and one bit that may be zero if the product is less than 2^127. If these
+/// bits of the high word are all ones, they could be changed by carry from the
+/// lower part, so the next 64 bits of the power of five are taken into account.
+///
+template<typename FloatT>
+uint64_t multiply_power5(int q, uint64_t w, uint64_t &high) {
+  typedef BinaryFormat<FloatT> Format;
+  typedef Power5Table<> Table;
+  assert(q >= Table::MinPower && q <= Table::MaxPower);
+  const int precision = Format::mantissa_bits + 3;
+  const uint64_t precision_mask = ~uint64_t(0) >> precision;
+  const int index = 2 * (q - Table::MinPower);
+  uint64_t low = multiply_128(w, Table::values[index], high);
+  if ((high & precision_mask) == precision_mask) {
+    uint64_t second_high;
+    multiply_128(w, Table::values[index + 1], second_high);
+    low += second_high;
+    if (second_high > low)
+      ++high;
+  }
+  return low;
+}
+
+
+/// \brief Converts w * 10^q into binary float number.
+///
+/// \param[in] q  Decimal exponent.
+/// \param[in] w  Decimal mantissa.
+///
+/// \returns Correctly rounded result if \c w is the exact mantissa.
+///
+/// This is the algorithm of Michael Eisel and Daniel Lemire. Decimal mantissa
+/// is multiplied by the truncated 128-bit approximation of 5^q, bits of the
+/// product that can be affected by truncation are checked separately. Factor
+/// 2^q is accounted in the binary exponent.
+///
+/// If the result is too large, \c power2 is set to the biased exponent of
+/// infinity. If it is too small, both mantissa and exponent are zero.
+///
+template<typename FloatT>
+BinaryFloat compute_float(int q, uint64_t w) {
+  typedef BinaryFormat<FloatT> Format;
+  BinaryFloat answer;
+
+  if (w == 0 || q < Format::min_power10) {
+    answer.power2 = 0;
+    answer.mantissa = 0;
+    return answer;
+  }
+  if (q > Format::max_power10) {
+    answer.power2 = Format::infinite_power;
+    answer.mantissa = 0;
+    return answer;
+  }
+
+  int lz = leading_zeros(w);
+  w <<= lz;
+  uint64_t high;
+  uint64_t low = multiply_power5<FloatT>(q, w, high);
+
+  int upper_bit = static_cast<int>(high >> 63);
+  int shift = upper_bit + 64 - Format::mantissa_bits - 3;
+  answer.mantissa = high >> shift;
+  answer.power2 = power10_exp2(q) + upper_bit - lz + Format::exponent_bias;
+
+  // Denormalized numbers.
+  if (answer.power2 <= 0) {
+    if (-answer.power2 + 1 >= 64) {
+      answer.power2 = 0;
+      answer.mantissa = 0;
+      return answer;
+    }
+    answer.mantissa >>= -answer.power2 + 1;
+    answer.mantissa += answer.mantissa & 1;
+    answer.mantissa >>= 1;
+    answer.power2 =
+      answer.mantissa < (uint64_t(1) << Format::mantissa_bits) ? 0 : 1;
+    return answer;
+  }
+
+  // Exact halfway case, only possible for small powers of ten. In this case
+  // round to even.
+  if (low <= 1 && q >= Format::min_round_to_even &&
+      q <= Format::max_round_to_even && (answer.mantissa & 3) == 1) {
+    if ((answer.mantissa << shift) == high)
+      answer.mantissa &= ~uint64_t(1);
+  }
+
+  answer.mantissa += answer.mantissa & 1;
+  answer.mantissa >>= 1;
+  if (answer.mantissa >= (uint64_t(2) << Format::mantissa_bits)) {
+    answer.mantissa = uint64_t(1) << Format::mantissa_bits;
+    ++answer.power2;
+  }
+  answer.mantissa &= ~(uint64_t(1) << Format::mantissa_bits);
+  if (answer.power2 >= Format::infinite_power) {
+    answer.power2 = Format::infinite_power;
+    answer.mantissa = 0;
+  }
+  return answer;
+}
+
+
+/// \brief Returns unrounded approximation of w * 10^q, which is used as a
+/// starting point for digit comparison.
+///
+/// Mantissa of the result is normalized 64-bit number, \c power2 is the biased
+/// exponent it would have if mantissa had \c mantissa_bits bits.
+///
+template<typename FloatT>
+BinaryFloat compute_error(int q, uint64_t w) {
+  typedef BinaryFormat<FloatT> Format;
+  int lz = leading_zeros(w);
+  w <<= lz;
+  uint64_t high;
+  multiply_power5<FloatT>(q, w, high);
+  int hilz = static_cast<int>(high >> 63) ^ 1;
+  BinaryFloat answer;
+  answer.mantissa = high << hilz;
+  int bias = Format::mantissa_bits + Format::exponent_bias;
+  answer.power2 = power10_exp2(q) + bias - hilz - lz - 62;
+  return answer;
+}
+
+
+/// \brief Rounds extended number \c am, which has 64-bit mantissa, to the
+/// precision of FloatT.
+///
+/// \param am    Number to round.
+/// \param shift Function object that gets the number and the amount of bits to
+///              remove and actually removes them with appropriate rounding.
+///
+template<typename FloatT, typename ShiftFn>
+void round_binary(BinaryFloat &am, ShiftFn shift) {
+  typedef BinaryFormat<FloatT> Format;
+  const int mantissa_shift = 64 - Format::mantissa_bits - 1;
+  if (-am.power2 >= mantissa_shift) {
+    // Denormalized number.
+    int n = -am.power2 + 1;
+    shift(am, n < 64 ? n : 64);
+    am.power2 = am.mantissa < (uint64_t(1) << Format::mantissa_bits) ? 0 : 1;
+    return;
+  }
+  shift(am, mantissa_shift);
+  if (am.mantissa >= (uint64_t(2) << Format::mantissa_bits)) {
+    am.mantissa = uint64_t(1) << Format::mantissa_bits;
+    ++am.power2;
+  }
+  am.mantissa &= ~(uint64_t(1) << Format::mantissa_bits);
+  if (am.power2 >= Format::infinite_power) {
+    am.power2 = Format::infinite_power;
+    am.mantissa = 0;
+  }
+}
+
+
+/// \brief Removes \c shift lower bits of the mantissa, rounding the result
+/// up if the function \c round_up tells so.
+///
+/// \c round_up gets three arguments: if the result is odd, if the removed
+/// bits are exactly halfway and if they are above halfway.
+///
+template<typename RoundFn>
+void round_nearest(BinaryFloat &am, int shift, RoundFn round_up) {
+  uint64_t mask = shift == 64 ? ~uint64_t(0) : (uint64_t(1) << shift) - 1;
+  uint64_t halfway = shift == 0 ? 0 : uint64_t(1) << (shift - 1);
+  uint64_t truncated_bits = am.mantissa & mask;
+  bool is_above = truncated_bits > halfway;
+  bool is_halfway = truncated_bits == halfway;
+  am.mantissa = shift == 64 ? 0 : am.mantissa >> shift;
+  am.power2 += shift;
+  bool is_odd = (am.mantissa & 1) != 0;
+  am.mantissa += round_up(is_odd, is_halfway, is_above) ? 1 : 0;
+}
+
+
+/// \brief Returns number halfway between the given value and the next
+/// representable value in the form of extended number.
+///
+template<typename FloatT>
+BinaryFloat to_extended_halfway(FloatT value) {
+  typedef BinaryFormat<FloatT> Format;
+  typedef typename Format::bits_type bits_type;
+  const bits_type mantissa_mask = (bits_type(1) << Format::mantissa_bits) - 1;
+  int bias = Format::mantissa_bits + Format::exponent_bias;
+  bits_type bits;
+  memcpy(&bits, &value, sizeof(bits));
+  BinaryFloat am;
+  int biased_exp = static_cast<int>(bits >> Format::mantissa_bits)
+                 & Format::infinite_power;
+  if (biased_exp == 0) {
+    am.power2 = 1 - bias;
+    am.mantissa = bits & mantissa_mask;
+  } else {
+    am.power2 = biased_exp - bias;
+    am.mantissa = (bits & mantissa_mask) | (bits_type(1) << Format::mantissa_bits);
+  }
+  am.mantissa = (am.mantissa << 1) + 1;
+  am.power2 -= 1;
+  return am;
+}
+
+
+/// \brief Collects significant decimal digits into big integer.
+///
+/// At most \c max_digits are stored. If some of the remaining digits are not
+/// zero, the stored value is extended by digit 1, it makes the number slightly
+/// larger than the truncated value, which is enough for correct rounding.
+///
+class BigMantissa {
+public:
+  BigInteger value;
+  unsigned digits;
+
+  explicit BigMantissa(unsigned max)
+    : digits(0), max_digits(max), chunk(0), chunk_digits(0), truncated(false) {
+  }
+
+  template<typename CharT>
+  void append(const CharT *str, unsigned len) {
+    const CharT *end = str + len;
+    if (digits == 0)
+      while (str != end && *str == CharT('0'))
+        ++str;
+    for (; str != end; ++str) {
+      if (digits == max_digits) {
+        if (*str != CharT('0')) {
+          truncated = true;
+          break;
+        }
+        continue;
+      }
+      chunk = 10 * chunk + static_cast<unsigned>(*str - CharT('0'));
+      ++digits;
+      if (++chunk_digits == 19)
+        flush();
+    }
+  }
+
+  void finish() {
+    flush();
+    if (truncated) {
+      bool ok = value.multiply_add(10, 1);
+      assert(ok); (void)ok;
+      ++digits;
+    }
+  }
+
+private:
+  unsigned max_digits;
+  uint64_t chunk;
+  unsigned chunk_digits;
+  bool truncated;
+
+  void flush() {
+    static const uint64_t powers[] = {
+      1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+      10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+      100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+      100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+      100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+    };
+    if (chunk_digits == 0)
+      return;
+    bool ok = value.multiply_add(powers[chunk_digits], chunk);
+    assert(ok); (void)ok;
+    chunk = 0;
+    chunk_digits = 0;
+  }
+};
+
+
+/// \brief Finds correctly rounded float number by exact comparison of decimal
+/// digits with binary values.
+///
+/// \param int_str, int_len   Digits of integer part.
+/// \param frac_str, frac_len Digits of fractional part.
+/// \param sci_exp            Decimal exponent of the first significant digit.
+/// \param am                 Approximation obtained by compute_error.
+///
+/// If the number is an integer, it is calculated exactly as big integer and
+/// its highest bits are rounded. Otherwise the digits are compared with the
+/// number halfway between the approximation rounded down and the next float,
+/// both scaled to the same exponents.
+///
+template<typename FloatT, typename CharT>
+BinaryFloat compare_digits(const CharT *int_str, unsigned int_len,
+                           const CharT *frac_str, unsigned frac_len,
+                           int sci_exp, BinaryFloat am) {
+  typedef BinaryFormat<FloatT> Format;
+  BigMantissa mant(Format::max_digits);
+  mant.append(int_str, int_len);
+  mant.append(frac_str, frac_len);
+  mant.finish();
+  int exponent = sci_exp + 1 - static_cast<int>(mant.digits);
+  BigInteger &real_digits = mant.value;
+  bool ok;
+
+  if (exponent >= 0) {
+    ok = real_digits.multiply_pow10(static_cast<unsigned>(exponent));
+    assert(ok);
+    bool truncated;
+    BinaryFloat answer;
+    answer.mantissa = real_digits.high64(truncated);
+    answer.power2 = static_cast<int>(real_digits.bit_length()) - 64
+                  + Format::mantissa_bits + Format::exponent_bias;
+    round_binary<FloatT>(answer, [truncated](BinaryFloat &a, int shift) {
+      round_nearest(a, shift,
+                    [truncated](bool is_odd, bool is_halfway, bool is_above) {
+        return is_above || (is_halfway && truncated) || (is_odd && is_halfway);
+      });
+    });
+    return answer;
+  }
+
+  // Get the value b, which is the approximation rounded down, and compare
+  // the digits with b+h, where h is the half of unit in the last place.
+  BinaryFloat am_b = am;
+  round_binary<FloatT>(am_b, [](BinaryFloat &a, int shift) {
+    a.mantissa = shift == 64 ? 0 : a.mantissa >> shift;
+    a.power2 += shift;
+  });
+  FloatT b = assemble_float<FloatT>(am_b.mantissa, am_b.power2, false);
+  BinaryFloat theor = to_extended_halfway(b);
+  BigInteger theor_digits(theor.mantissa);
+
+  // Scale both numbers to the same power: real = digits * 5^exp * 2^exp,
+  // theor = mantissa * 2^power2.
+  int pow2_exp = theor.power2 - exponent;
+  ok = theor_digits.multiply_pow5(static_cast<unsigned>(-exponent));
+  assert(ok);
+  if (pow2_exp > 0)
+    ok = theor_digits.shift_left(static_cast<unsigned>(pow2_exp));
+  else if (pow2_exp < 0)
+    ok = real_digits.shift_left(static_cast<unsigned>(-pow2_exp));
+  assert(ok); (void)ok;
+
+  int order = real_digits.compare(theor_digits);
+  BinaryFloat answer = am;
+  round_binary<FloatT>(answer, [order](BinaryFloat &a, int shift) {
+    round_nearest(a, shift, [order](bool is_odd, bool, bool) {
+      if (order > 0)
+        return true;
+      if (order < 0)
+        return false;
+      return is_odd;
+    });
+  });
+  return answer;
+}
+
+}
+
+
+/// \brief Converts decimal number into floating point value.
+///
+/// \tparam FloatT Target floating point type, float or double.
+/// \tparam CharT  Type of character data.
+///
+/// \param[out] value     Variable that gets converted number.
+/// \param[in]  int_str   Digits of integer part.
+/// \param[in]  int_len   Number of digits in integer part.
+/// \param[in]  frac_str  Digits of fractional part.
+/// \param[in]  frac_len  Number of digits in fractional part.
+/// \param[in]  exponent  Value of decimal exponent.
+/// \param[in]  negative  True if the number is negative.
+///
+/// \returns Status of conversion.
+///
+/// The function gets parts of a number as they are found by NumberRecognizer,
+/// both integer and fractional part must contain decimal digits only. Result is
+/// correctly rounded. If the number is too large, the maximal value of FloatT
+/// is returned with status DoubleOverflow or DoubleOverflowNegative. If the
+/// number is too small, zero is returned with status DoubleUnderflow.
+///
+template<typename FloatT, typename CharT>
+Status convert_float(FloatT &value,
+                     const CharT *int_str, unsigned int_len,
+                     const CharT *frac_str, unsigned frac_len,
+                     int exponent, bool negative) {
+  typedef internal::BinaryFormat<FloatT> Format;
+  const unsigned MaxMantissaDigits = 19;
+
+  // Collect up to 19 significant digits into 64-bit mantissa. Digits of
+  // integer part that do not fit the mantissa increase exponent.
+  uint64_t mantissa = 0;
+  unsigned num_digits = 0;
+  int exp10 = exponent;
+  bool truncated = false;
+  const CharT *cursor = int_str;
+  const CharT *end = int_str + int_len;
+  while (cursor != end && *cursor == CharT('0'))
+    ++cursor;
+  for (; cursor != end; ++cursor) {
+    if (num_digits < MaxMantissaDigits) {
+      mantissa = 10 * mantissa + static_cast<unsigned>(*cursor - CharT('0'));
+      ++num_digits;
+    } else {
+      ++exp10;
+      if (*cursor != CharT('0'))
+        truncated = true;
+    }
+  }
+  cursor = frac_str;
+  end = frac_str + frac_len;
+  if (num_digits == 0) {
+    while (cursor != end && *cursor == CharT('0')) {
+      ++cursor;
+      --exp10;
+    }
+  }
+  for (; cursor != end; ++cursor) {
+    if (num_digits < MaxMantissaDigits) {
+      mantissa = 10 * mantissa + static_cast<unsigned>(*cursor - CharT('0'));
+      ++num_digits;
+      --exp10;
+    } else if (*cursor != CharT('0')) {
+      truncated = true;
+      break;
+    }
+  }
+
+  if (num_digits == 0) {
+    value = negative ? -FloatT(0) : FloatT(0);
+    return OK;
+  }
+
+  // Fast path: if both mantissa and power of ten are exactly representable,
+  // single multiplication or division produces correctly rounded result.
+#if !defined(FLT_EVAL_METHOD) || FLT_EVAL_METHOD == 0 || FLT_EVAL_METHOD == 1
+  const uint64_t MaxExactMantissa = uint64_t(1) << (Format::mantissa_bits + 1);
+  if (!truncated && mantissa <= MaxExactMantissa &&
+      exp10 >= -Format::max_exact_exponent10 &&
+      exp10 <= Format::max_exact_exponent10) {
+    FloatT result = static_cast<FloatT>(mantissa);
+    if (exp10 < 0)
+      result = result / Format::exact_power10(-exp10);
+    else
+      result = result * Format::exact_power10(exp10);
+    value = negative ? -result : result;
+    return OK;
+  }
+#endif
+
+  // Eisel-Lemire algorithm. If the mantissa was truncated, the exact value is
+  // between w and w+1, in this case the result is known only if both bounds
+  // produce the same binary number. Otherwise digits are compared exactly.
+  internal::BinaryFloat bin = internal::compute_float<FloatT>(exp10, mantissa);
+  if (truncated &&
+      bin != internal::compute_float<FloatT>(exp10, mantissa + 1)) {
+    int sci_exp = exp10 + static_cast<int>(num_digits) - 1;
+    bin = internal::compute_error<FloatT>(exp10, mantissa);
+    bin = internal::compare_digits<FloatT>(int_str, int_len, frac_str, frac_len,
+                                           sci_exp, bin);
+  }
+
+  if (bin.power2 == Format::infinite_power)
+    return internal::set_float_overflow(value, negative);
+  value = internal::assemble_float<FloatT>(bin.mantissa, bin.power2, negative);
+  if (bin.mantissa == 0 && bin.power2 == 0)
+    return DoubleUnderflow;
+  return OK;
+}
+
+
+/// \brief Variant of convert_float which gets text parts in the form of
+/// std::tuple.
+///
+template<typename FloatT, typename CharT>
+Status convert_float(FloatT &value,
+                     std::tuple<const CharT *, unsigned> int_part,
+                     std::tuple<const CharT *, unsigned> frac_part,
+                     int exponent, bool negative) {
+  return convert_float(value, std::get<0>(int_part), std::get<1>(int_part),
+                       std::get<0>(frac_part), std::get<1>(frac_part),
+                       exponent, negative);
+}
+
+
+/// \brief Converts number in hexadecimal float notation to floating point
+/// type.
+///
+/// \param[out] value     Receives the result.
+/// \param[in]  int_str   Hexadecimal digits of integer part.
+/// \param[in]  int_len   Number of digits in integer part.
+/// \param[in]  frac_str  Hexadecimal digits of fractional part.
+/// \param[in]  frac_len  Number of digits in fractional part.
+/// \param[in]  exponent  Binary exponent.
+/// \param[in]  negative  True if the number is negative.
+///
+/// \returns Status of conversion, the same as convert_float returns.
+///
+/// Every digit is exactly four bits of the mantissa, so no decimal scaling is
+/// needed. Up to sixteen significant digits are collected in 64-bit integer,
+/// the following ones only matter if they are not zero. The bits that do not
+/// fit the mantissa of FloatT, including those lost by denormalization, are
+/// rounded half to even, then the value is assembled from its fields.
+///
+template<typename FloatT, typename CharT>
+Status convert_hex_float(FloatT &value,
+                         const CharT *int_str, unsigned int_len,
+                         const CharT *frac_str, unsigned frac_len,
+                         int exponent, bool negative) {
+  typedef internal::BinaryFormat<FloatT> Format;
+  const unsigned MaxMantissaDigits = 16;
+
+  uint64_t mantissa = 0;
+  unsigned num_digits = 0;
+  long long exp2 = exponent;
+  bool sticky = false;
+  const CharT *cursor = int_str;
+  const CharT *end = int_str + int_len;
+  while (cursor != end && *cursor == CharT('0'))
+    ++cursor;
+  for (; cursor != end; ++cursor) {
+    unsigned digit = internal::digit_value(*cursor);
+    if (num_digits < MaxMantissaDigits) {
+      mantissa = (mantissa << 4) | digit;
+      ++num_digits;
+    } else {
+      exp2 += 4;
+      sticky |= digit != 0;
+    }
+  }
+  cursor = frac_str;
+  end = frac_str + frac_len;
+  if (num_digits == 0) {
+    while (cursor != end && *cursor == CharT('0')) {
+      ++cursor;
+      exp2 -= 4;
+    }
+  }
+  for (; cursor != end; ++cursor) {
+    unsigned digit = internal::digit_value(*cursor);
+    if (num_digits < MaxMantissaDigits) {
+      mantissa = (mantissa << 4) | digit;
+      ++num_digits;
+      exp2 -= 4;
+    } else if (digit) {
+      sticky = true;
+      break;
+    }
+  }
+
+  if (num_digits == 0) {
+    value = negative ? -FloatT(0) : FloatT(0);
+    return OK;
+  }
+
+  // Normalize the mantissa, so that its highest bit is set. The value is then
+  // 1.xxx * 2^(exp2 + 63).
+  int lz = internal::leading_zeros(mantissa);
+  mantissa <<= lz;
+  exp2 -= lz;
+  long long power2 = exp2 + 63 + Format::exponent_bias;
+  if (power2 >= Format::infinite_power)
+    return internal::set_float_overflow(value, negative);
+
+  // Number of low bits that do not fit the mantissa. Denormalized numbers
+  // lose additional bits.
+  long long shift = 63 - Format::mantissa_bits;
+  if (power2 <= 0) {
+    shift += 1 - power2;
+    power2 = 0;
+  }
+  uint64_t kept = 0;
+  bool half = false;
+  if (shift < 64) {
+    kept = mantissa >> shift;
+    half = (mantissa >> (shift - 1)) & 1;
+    sticky |= (mantissa & ((uint64_t(1) << (shift - 1)) - 1)) != 0;
+  } else if (shift == 64) {
+    half = true;
+    sticky |= (mantissa << 1) != 0;
+  } else {
+    sticky = true;
+  }
+  if (half && (sticky || (kept & 1)))
+    ++kept;
+
+  // Rounding may carry into the next power of two, which makes denormalized
+  // number normalized or increases the exponent.
+  const uint64_t implicit_bit = uint64_t(1) << Format::mantissa_bits;
+  if (kept >> (Format::mantissa_bits + 1)) {
+    kept >>= 1;
+    if (++power2 >= Format::infinite_power)
+      return internal::set_float_overflow(value, negative);
+  } else if (power2 == 0 && (kept & implicit_bit)) {
+    power2 = 1;
+  }
+
+  value = internal::assemble_float<FloatT>(kept & (implicit_bit - 1),
+                                           static_cast<int>(power2), negative);
+  if (kept == 0)
+    return DoubleUnderflow;
+  return OK;
+}
+
+
+/// \brief Variant of convert_hex_float which gets text parts in the form of
+/// std::tuple.
+///
+template<typename FloatT, typename CharT>
+Status convert_hex_float(FloatT &value,
+                         std::tuple<const CharT *, unsigned> int_part,
+                         std::tuple<const CharT *, unsigned> frac_part,
+                         int exponent, bool negative) {
+  return convert_hex_float(value, std::get<0>(int_part), std::get<1>(int_part),
+                           std::get<0>(frac_part), std::get<1>(frac_part),
+                           exponent, negative);
+}
+
+}
+#endif
@@ -0,0 +1,149 @@
+//===--- mapped_file.h ------------------------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Reading numbers from memory mapped files.
+///
+/// The file is mapped into memory and the recognizer runs directly over the
+/// mapped pages, no text is copied. Each number is reported together with its
+/// status and offset in the file.
+///
+//===----------------------------------------------------------------------===//
+#ifndef CONVERSION_MAPPED_FILE_H_
+#define CONVERSION_MAPPED_FILE_H_
+
+//------ Dependencies ----------------------------------------------------------
+#include "column_parser.h"
+#include <stddef.h>
+//------------------------------------------------------------------------------
+
+
+namespace conversion {
+
+/// \brief Read-only memory mapping of a file.
+///
+/// The mapping is advised for sequential access. Empty file is represented
+/// by successfully opened object of zero size.
+///
+class MappedFile {
+public:
+  MappedFile() : start(nullptr), length(0), error_code(0) {}
+  explicit MappedFile(const char *path) : MappedFile() { open(path); }
+  MappedFile(MappedFile &&other)
+    : start(other.start), length(other.length), error_code(other.error_code) {
+    other.start = nullptr;
+    other.length = 0;
+  }
+  MappedFile &operator=(MappedFile &&other);
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  ~MappedFile() { close(); }
+
+  /// \brief Maps the specified file.
+  ///
+  /// \returns False if the file cannot be mapped, error() returns system error
+  ///          code in this case.
+  ///
+  bool open(const char *path);
+
+  /// \brief Unmaps the file.
+  void close();
+
+  const char *data() const { return start; }
+  size_t size() const { return length; }
+  int error() const { return error_code; }
+
+private:
+  const char *start;
+  size_t length;
+  int error_code;
+};
+
+
+/// \brief Number found in a buffer.
+///
+template<typename NumType>
+struct NumberRecord {
+  NumType value;    ///< Converted value
+  Status status;    ///< Conversion status
+  size_t offset;    ///< Offset of the field that contains the number
+};
+
+
+/// \brief Reads numbers from fields of a buffer separated by delimiter.
+///
+/// \tparam NumType     Type of the numbers.
+/// \tparam RecognizerT Recognizer used for conversion.
+///
+/// Fields are determined and converted as in parse_delimited. The buffer is
+/// accessed only within the specified length, so it may be a memory mapped
+/// file, in which the last number ends at the end of the mapping. A field of
+/// 4 GiB or more gets status NaN.
+///
+template<typename NumType,
+         typename RecognizerT = StaticNumberRecognizer<DefaultOptions> >
+class NumberReader {
+public:
+  NumberReader(const char *buf, size_t len, char delim = '\n')
+    : start(buf), cursor(buf), finish(buf + len), delimiter(delim) {}
+
+  explicit NumberReader(const MappedFile &file, char delim = '\n')
+    : NumberReader(file.data(), file.size(), delim) {}
+
+  /// \brief Reads next number.
+  ///
+  /// \returns False if there are no more fields.
+  ///
+  bool next(NumberRecord<NumType> &record) {
+    if (cursor == finish)
+      return false;
+    const char *field_end = std::char_traits<char>::find(
+      cursor, finish - cursor, delimiter);
+    if (!field_end)
+      field_end = finish;
+    record.offset = cursor - start;
+    record.status = internal::parse_element(
+      recognizer, cursor, size_t(field_end - cursor), record.value);
+    cursor = (field_end == finish) ? finish : field_end + 1;
+    return true;
+  }
+
+  /// \brief Returns offset of the next field.
+  size_t offset() const { return cursor - start; }
+
+private:
+  RecognizerT recognizer;
+  const char *start;
+  const char *cursor;
+  const char *finish;
+  char delimiter;
+};
+
+}
+#endif
@@ -326,15 +326,20 @@ public:
 ///
 /// \tparam DType Destination type.
 /// \tparam SType Source type.
+/// \tparam MayOverflow True if the integer type has values that exceed the
+///                     range of the float type.
 ///
 /// The class contains static method <tt>convert(const SType &x)</tt>, which
 /// converts value of \c x to the value of the destination type and returns it
 /// with the status of conversion.
 ///
-/// We assume that absolute value of the integer is withing range of the
-/// float type.
+/// Only 128-bit unsigned integer may be out of range of float, for other
+/// combinations of types we assume that absolute value of the integer is
+/// within range of the float type.
 ///
-template<typename DType, typename SType>
+template<typename DType, typename SType,
+         bool MayOverflow = (std::numeric_limits<SType>::digits >=
+                             std::numeric_limits<DType>::max_exponent)>
 class ConvertToFloat {
   static_assert(!std::numeric_limits<DType>::is_integer, "Must be float");
   static_assert(std::numeric_limits<SType>::is_integer, "Must be integer");
@@ -345,6 +350,32 @@ public:
   }
 };
 
+template<typename DType, typename SType>
+class ConvertToFloat<DType, SType, true> {
+  static_assert(!std::numeric_limits<DType>::is_integer, "Must be float");
+  static_assert(std::numeric_limits<SType>::is_integer, "Must be integer");
+  static_assert(!std::numeric_limits<SType>::is_signed, "Must be unsigned");
+
+  static constexpr SType max_value() {
+    return static_cast<SType>(std::numeric_limits<DType>::max());
+  }
+
+  // Values from max_value() up to half of the last unit in the last place
+  // above it are rounded down to max_value(), larger ones to infinity.
+  static constexpr SType half_ulp() {
+    return SType(1) << (std::numeric_limits<DType>::max_exponent -
+                        std::numeric_limits<DType>::digits - 1);
+  }
+
+public:
+  static constexpr Result<DType> convert(const SType &x) {
+    return x > max_value() && x - max_value() >= half_ulp()
+      ? Result<DType>(std::numeric_limits<DType>::max(),
+                      Status::DoubleOverflow)
+      : Result<DType>(static_cast<DType>(x));
+  }
+};
+
 
 /// \brief Helper class used to convert value of one numeric type to another.
 ///
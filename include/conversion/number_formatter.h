@@ -0,0 +1,588 @@
+//===--- number_formatter.h -------------------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Conversion of numbers to text.
+///
+/// Functions of this file write text representation of numbers into buffers
+/// supplied by caller and never allocate memory.
+///
+//===----------------------------------------------------------------------===//
+#ifndef CONVERSION_NUMBER_FORMATTER_H_
+#define CONVERSION_NUMBER_FORMATTER_H_
+
+//------ Dependencies ----------------------------------------------------------
+#include "number_recognizer.h"
+#include "arithmetic.h"
+#include "float_convert.h"
+#include "power10_table.h"
+#include <cmath>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <string.h>
+//------------------------------------------------------------------------------
+
+
+namespace conversion {
+
+/// Options that control number formatting.
+enum FormatOption {
+  FormatUpper  = 0x001,   ///< Use upper case letters for digits and prefix
+  FormatPrefix = 0x002,   ///< Write prefix 0x, 0o or 0b for bases 16, 8, 2
+  FormatPlus   = 0x004,   ///< Write '+' before nonnegative numbers
+  DefaultFormat = 0       ///< Default option set
+};
+
+
+/// Pairs of decimal digits: "00010203...9899".
+extern const char decimal_pairs[];
+
+
+/// Maximal number of characters produced by format_int for any value of 64-bit
+/// or smaller integer type: 64 binary digits, sign and prefix.
+const unsigned MaxIntTextLength = 64 + 1 + 2;
+
+
+/// Notations of floating point numbers.
+enum FloatNotation {
+  GeneralNotation,      ///< Fixed or scientific, chosen as printf "%g" does
+  ScientificNotation,   ///< One digit before decimal point and exponent
+  FixedNotation         ///< No exponent
+};
+
+
+/// Maximal number of characters produced by format_float for any value of
+/// float or double: fixed notation of the smallest negative subnormal double.
+const unsigned MaxFloatTextLength = 327;
+
+
+namespace internal {
+
+/// \brief Returns number of decimal digits in the value.
+///
+/// Number of bits gives an estimate of decimal logarithm, which is corrected
+/// by single comparison with power of ten.
+///
+inline unsigned decimal_length(uint64_t value) {
+  value |= 1;
+  unsigned estimate = (bit_length(value) * 1233) >> 12;
+  return estimate + 1 - (value < Power10Integers<>::values[estimate]);
+}
+
+
+/// \brief Returns number of digits of the value in the specified base.
+///
+inline unsigned digit_length(uint64_t value, unsigned base) {
+  if (base == 10)
+    return decimal_length(value);
+  if ((base & (base - 1)) == 0) {
+    unsigned shift = bit_length(base) - 1;
+    return (bit_length(value | 1) + shift - 1) / shift;
+  }
+  unsigned length = 1;
+  for (; value >= base; value /= base)
+    ++length;
+  return length;
+}
+
+
+/// \brief Returns length of the prefix written for the base.
+///
+inline unsigned prefix_length(unsigned base, unsigned flags) {
+  return (flags & FormatPrefix) && (base == 16 || base == 8 || base == 2) ? 2
+                                                                          : 0;
+}
+
+
+/// \brief Returns absolute value of integer number in unsigned type.
+///
+/// Negation is made in unsigned type, so the minimal value of signed type is
+/// handled correctly.
+///
+template<typename IntType>
+typename std::make_unsigned<IntType>::type magnitude(IntType value) {
+  typedef typename std::make_unsigned<IntType>::type UIntType;
+  UIntType result = static_cast<UIntType>(value);
+  return value < 0 ? UIntType(0) - result : result;
+}
+
+
+/// \brief Writes digits of the value into the buffer, ending at the specified
+/// position.
+///
+/// \returns Pointer to the first written digit.
+///
+template<typename CharT, typename UIntType>
+CharT *write_digits(CharT *end, UIntType value, unsigned base,
+                    const char *digits) {
+  CharT *cursor = end;
+  if (base == 10) {
+    while (value >= 100) {
+      const char *pair = decimal_pairs + 2 * static_cast<unsigned>(value % 100);
+      value /= 100;
+      *--cursor = static_cast<CharT>(pair[1]);
+      *--cursor = static_cast<CharT>(pair[0]);
+    }
+    if (value >= 10) {
+      const char *pair = decimal_pairs + 2 * static_cast<unsigned>(value);
+      *--cursor = static_cast<CharT>(pair[1]);
+      *--cursor = static_cast<CharT>(pair[0]);
+    } else {
+      *--cursor = static_cast<CharT>('0' + value);
+    }
+  } else if ((base & (base - 1)) == 0) {
+    unsigned shift = bit_length(base) - 1;
+    UIntType mask = static_cast<UIntType>(base - 1);
+    do {
+      unsigned digit = static_cast<unsigned>(value & mask);
+      *--cursor = static_cast<CharT>(digits[digit]);
+      value >>= shift;
+    } while (value);
+  } else {
+    do {
+      unsigned digit = static_cast<unsigned>(value % base);
+      *--cursor = static_cast<CharT>(digits[digit]);
+      value /= base;
+    } while (value);
+  }
+  return cursor;
+}
+
+
+/// \brief Writes text of integer number, ending at the specified position.
+///
+/// The base must be valid, the buffer must have room for the text.
+///
+template<typename CharT, typename IntType>
+void write_int(CharT *end, IntType value, unsigned base, unsigned flags) {
+  bool upper = (flags & FormatUpper) != 0;
+  CharT *cursor = write_digits(end, magnitude(value), base,
+                               upper ? upper_digits : lower_digits);
+  if (prefix_length(base, flags)) {
+    char marker = base == 16 ? 'x' : base == 8 ? 'o' : 'b';
+    *--cursor = static_cast<CharT>(upper ? marker - 'a' + 'A' : marker);
+    *--cursor = CharT('0');
+  }
+  if (value < 0)
+    *--cursor = CharT('-');
+  else if (flags & FormatPlus)
+    *--cursor = CharT('+');
+}
+
+}
+
+
+/// \brief Upper bound of text length produced by format_int for any value of
+/// the type in the specified base, including sign and prefix.
+///
+/// \returns The bound, or 0 if the base is invalid.
+///
+template<typename IntType>
+constexpr unsigned max_formatted_length(unsigned base = 10) {
+  static_assert(std::numeric_limits<IntType>::is_integer,
+                "max_formatted_length requires integer type");
+  if (base < MinBase || base > MaxBase)
+    return 0;
+  unsigned length = 1;
+  for (auto limit = std::numeric_limits<
+         typename std::make_unsigned<IntType>::type>::max() / base;
+       limit; limit /= base)
+    ++length;
+  return length + 1 + 2;
+}
+
+
+/// \brief Returns number of characters that format_int writes for the value.
+///
+/// \returns Length of the text, or 0 if the base is invalid.
+///
+template<typename IntType>
+unsigned formatted_length(IntType value, unsigned base = 10,
+                          unsigned flags = DefaultFormat) {
+  static_assert(std::numeric_limits<IntType>::is_integer,
+                "formatted_length requires integer type");
+  static_assert(sizeof(IntType) <= 8, "integer type is too large");
+  if (base < MinBase || base > MaxBase)
+    return 0;
+  return internal::digit_length(internal::magnitude(value), base) +
+         internal::prefix_length(base, flags) +
+         (value < 0 || (flags & FormatPlus) ? 1 : 0);
+}
+
+
+/// \brief Writes text representation of an integer number.
+///
+/// \tparam CharT   Character type of the output.
+/// \tparam IntType Type of the number, signed or unsigned integer.
+/// \param buf      Buffer to write to.
+/// \param size     Size of the buffer in characters.
+/// \param value    The number to format.
+/// \param base     Base of the representation, 2..36.
+/// \param flags    Combination of FormatOption values.
+/// \returns Number of characters written, or 0 if the base is invalid or the
+///          buffer is too small. Terminating null character is not written.
+///
+/// Buffer of MaxIntTextLength characters is enough for any value.
+///
+template<typename CharT, typename IntType>
+unsigned format_int(CharT *buf, unsigned size, IntType value,
+                    unsigned base = 10, unsigned flags = DefaultFormat) {
+  unsigned length = formatted_length(value, base, flags);
+  if (length == 0 || length > size)
+    return 0;
+  internal::write_int(buf + length, value, base, flags);
+  return length;
+}
+
+
+/// \brief Returns number of characters that format_batch writes for the
+/// array of integer numbers.
+///
+/// \returns Total length of the texts and delimiters between them, or 0 if
+///          the base is invalid.
+///
+template<typename IntType>
+size_t batch_length(const IntType *values, size_t count, unsigned base = 10,
+                    unsigned flags = DefaultFormat) {
+  if (count == 0 || base < MinBase || base > MaxBase)
+    return 0;
+  size_t total = count - 1;
+  for (size_t i = 0; i < count; ++i)
+    total += formatted_length(values[i], base, flags);
+  return total;
+}
+
+
+/// \brief Writes text representations of integer numbers separated by
+/// delimiter.
+///
+/// \param buf    Buffer to write to.
+/// \param size   Size of the buffer in characters.
+/// \param values Numbers to format.
+/// \param count  Number of the numbers.
+/// \param delim  Character written between numbers.
+/// \returns Number of characters written, or 0 if the base is invalid or the
+///          buffer is too small, in the latter case nothing is written.
+///
+/// Total length is calculated first, so the text is written by single pass
+/// directly into its final place.
+///
+template<typename CharT, typename IntType>
+size_t format_batch(CharT *buf, size_t size, const IntType *values,
+                    size_t count, CharT delim, unsigned base = 10,
+                    unsigned flags = DefaultFormat) {
+  size_t total = batch_length(values, count, base, flags);
+  if (total == 0 || total > size)
+    return 0;
+  CharT *cursor = buf;
+  for (size_t i = 0; i < count; ++i) {
+    if (i)
+      *cursor++ = delim;
+    cursor += formatted_length(values[i], base, flags);
+    internal::write_int(cursor, values[i], base, flags);
+  }
+  return total;
+}
+
+
+/// \brief Appends text representations of integer numbers separated by
+/// delimiter to the string.
+///
+/// The string is resized once for the total length of the text.
+///
+/// \returns Number of characters appended.
+///
+template<typename CharT, typename IntType>
+size_t format_batch(std::basic_string<CharT> &out, const IntType *values,
+                    size_t count, CharT delim, unsigned base = 10,
+                    unsigned flags = DefaultFormat) {
+  size_t total = batch_length(values, count, base, flags);
+  if (total == 0)
+    return 0;
+  size_t start = out.size();
+  out.resize(start + total);
+  return format_batch(&out[start], total, values, count, delim, base, flags);
+}
+
+
+
+namespace internal {
+
+/// \brief Decimal representation of a floating point number, the value is
+/// digits * 10^exponent.
+///
+struct DecimalFloat {
+  uint64_t digits;
+  int exponent;
+};
+
+
+// Integer approximations of logarithms, exact for |e| < 1650.
+
+/// \brief Calculates floor(log10(2^e)).
+inline int floor_log10_pow2(int e) {
+  return (e * 1262611) >> 22;
+}
+
+/// \brief Calculates floor(log10(3/4 * 2^e)).
+inline int floor_log10_three_quarters_pow2(int e) {
+  return (e * 1262611 - 524031) >> 22;
+}
+
+/// \brief Calculates floor(log2(10^e)).
+inline int floor_log2_pow10(int e) {
+  return (e * 1741647) >> 19;
+}
+
+
+/// \brief Calculates upper 64 bits of 192-bit product g * cp, where g is
+/// 128-bit number, and rounds the result to odd.
+///
+inline uint64_t round_to_odd(const uint64_t *g, uint64_t cp) {
+  uint64_t x_high, y_high;
+  multiply_128(g[1], cp, x_high);
+  uint64_t y_low = multiply_128(g[0], cp, y_high);
+  uint64_t middle = y_low + x_high;
+  uint64_t high = y_high + (middle < x_high);
+  return high | (middle > 1);
+}
+
+
+/// \brief Finds the shortest decimal number that is converted back to the
+/// specified binary value.
+///
+/// \param value Finite nonzero number, sign is ignored.
+///
+/// The implementation follows the Schubfach algorithm by R. Giulietti. The
+/// decimal number is inside the rounding interval of the value, if several
+/// such numbers of the same length exist, the closest to the value is chosen.
+/// The result may have trailing zeros.
+///
+template<typename FloatT>
+DecimalFloat shortest_decimal(FloatT value) {
+  typedef BinaryFormat<FloatT> Format;
+  typedef typename Format::bits_type bits_type;
+  typedef Power10Table<> Table;
+  const int mantissa_bits = Format::mantissa_bits;
+
+  bits_type bits;
+  static_assert(sizeof(value) == sizeof(bits), "Unexpected float size");
+  memcpy(&bits, &value, sizeof(bits));
+  uint64_t fraction = bits & ((bits_type(1) << mantissa_bits) - 1);
+  int power2 = static_cast<int>(bits >> mantissa_bits) & Format::infinite_power;
+
+  // The value is c * 2^q.
+  uint64_t c;
+  int q;
+  if (power2) {
+    c = fraction | (uint64_t(1) << mantissa_bits);
+    q = power2 - Format::exponent_bias - mantissa_bits;
+    // Small integers are represented exactly.
+    if (q <= 0 && -q <= mantissa_bits && (c & ((uint64_t(1) << -q) - 1)) == 0)
+      return DecimalFloat{ c >> -q, 0 };
+  } else {
+    c = fraction;
+    q = 1 - Format::exponent_bias - mantissa_bits;
+  }
+
+  // Bounds of rounding interval are included if c is even, as the value is
+  // obtained from them by rounding to even. Lower bound is closer to the value
+  // if it is a power of two.
+  bool include_bounds = (c & 1) == 0;
+  bool lower_closer = fraction == 0 && power2 > 1;
+  uint64_t cbl = 4 * c - 2 + lower_closer;
+  uint64_t cb = 4 * c;
+  uint64_t cbr = 4 * c + 2;
+
+  // Scale the value and the bounds by 10^-k, so that the scaled value has
+  // enough decimal digits.
+  int k = lower_closer ? floor_log10_three_quarters_pow2(q)
+                       : floor_log10_pow2(q);
+  int h = q + floor_log2_pow10(-k) + 1;
+  const uint64_t *g = Table::values + 2 * (-k - Table::MinPower);
+  uint64_t vbl = round_to_odd(g, cbl << h);
+  uint64_t vb = round_to_odd(g, cb << h);
+  uint64_t vbr = round_to_odd(g, cbr << h);
+  uint64_t lower = vbl + !include_bounds;
+  uint64_t upper = vbr - !include_bounds;
+
+  // Try the number that has one digit less. At most one of its neighbors may
+  // be inside the interval.
+  uint64_t s = vb / 4;
+  if (s >= 10) {
+    uint64_t sp = s / 10;
+    bool lower_inside = lower <= 40 * sp;
+    bool upper_inside = 40 * sp + 40 <= upper;
+    if (lower_inside != upper_inside)
+      return DecimalFloat{ sp + upper_inside, k + 1 };
+  }
+
+  bool lower_inside = lower <= 4 * s;
+  bool upper_inside = 4 * s + 4 <= upper;
+  if (lower_inside != upper_inside)
+    return DecimalFloat{ s + upper_inside, k };
+
+  // Both neighbors are inside, choose the closest one, ties to even.
+  uint64_t middle = 4 * s + 2;
+  bool round_up = vb > middle || (vb == middle && (s & 1) != 0);
+  return DecimalFloat{ s + round_up, k };
+}
+
+
+/// \brief Writes decimal exponent in scientific notation: marker, optional
+/// minus sign and digits.
+///
+inline char *write_exponent(char *cursor, int exponent, bool upper) {
+  *cursor++ = upper ? 'E' : 'e';
+  if (exponent < 0) {
+    *cursor++ = '-';
+    exponent = -exponent;
+  }
+  char digits[4];
+  char *start = write_digits(digits + 4, static_cast<unsigned>(exponent), 10,
+                             lower_digits);
+  while (start != digits + 4)
+    *cursor++ = *start++;
+  return cursor;
+}
+
+}
+
+
+/// \brief Writes the shortest text representation of a floating point number
+/// that is converted back to the same value.
+///
+/// \tparam CharT    Character type of the output.
+/// \tparam FloatT   Type of the number, float or double.
+/// \param buf       Buffer to write to.
+/// \param size      Size of the buffer in characters.
+/// \param value     The number to format.
+/// \param notation  Notation of the output.
+/// \param flags     Combination of FormatUpper and FormatPlus.
+/// \returns Number of characters written, or 0 if the buffer is too small.
+///          Terminating null character is not written.
+///
+/// Scientific notation has the form "1.25e-7": exponent has no plus sign and no
+/// leading zeros. General notation uses fixed form if decimal exponent X of the
+/// number satisfies -4 <= X < max_digits10, and scientific form otherwise.
+/// Infinities and NaN are written as "inf" and "nan". The output does not
+/// depend on locale.
+///
+/// Buffer of MaxFloatTextLength characters is enough for any value, buffer of
+/// 32 characters is enough for general and scientific notations.
+///
+template<typename CharT, typename FloatT>
+unsigned format_float(CharT *buf, unsigned size, FloatT value,
+                      FloatNotation notation = GeneralNotation,
+                      unsigned flags = DefaultFormat) {
+  static_assert(std::is_same<FloatT, float>::value ||
+                std::is_same<FloatT, double>::value,
+                "format_float requires float or double");
+  bool upper = (flags & FormatUpper) != 0;
+  char text[MaxFloatTextLength];
+  char *cursor = text;
+
+  if (std::isnan(value)) {
+    memcpy(cursor, upper ? "NAN" : "nan", 3);
+    cursor += 3;
+  } else {
+    if (std::signbit(value))
+      *cursor++ = '-';
+    else if (flags & FormatPlus)
+      *cursor++ = '+';
+
+    if (std::isinf(value)) {
+      memcpy(cursor, upper ? "INF" : "inf", 3);
+      cursor += 3;
+    } else if (value == 0) {
+      *cursor++ = '0';
+      if (notation == ScientificNotation)
+        cursor = internal::write_exponent(cursor, 0, upper);
+    } else {
+      internal::DecimalFloat decimal = internal::shortest_decimal(value);
+      while (decimal.digits % 10 == 0) {
+        decimal.digits /= 10;
+        ++decimal.exponent;
+      }
+      char digits[20];
+      char *digits_end = digits + sizeof(digits);
+      char *digits_start = internal::write_digits(digits_end, decimal.digits,
+                                                  10, lower_digits);
+      int length = static_cast<int>(digits_end - digits_start);
+      int point = length + decimal.exponent;  // Digits before decimal point
+
+      if (notation == GeneralNotation) {
+        if (point - 1 < -4 ||
+            point - 1 >= std::numeric_limits<FloatT>::max_digits10)
+          notation = ScientificNotation;
+        else
+          notation = FixedNotation;
+      }
+
+      if (notation == ScientificNotation) {
+        *cursor++ = digits_start[0];
+        if (length > 1) {
+          *cursor++ = '.';
+          memcpy(cursor, digits_start + 1, length - 1);
+          cursor += length - 1;
+        }
+        cursor = internal::write_exponent(cursor, point - 1, upper);
+      } else if (point <= 0) {
+        *cursor++ = '0';
+        *cursor++ = '.';
+        memset(cursor, '0', -point);
+        cursor += -point;
+        memcpy(cursor, digits_start, length);
+        cursor += length;
+      } else if (point >= length) {
+        memcpy(cursor, digits_start, length);
+        cursor += length;
+        memset(cursor, '0', point - length);
+        cursor += point - length;
+      } else {
+        memcpy(cursor, digits_start, point);
+        cursor += point;
+        *cursor++ = '.';
+        memcpy(cursor, digits_start + point, length - point);
+        cursor += length - point;
+      }
+    }
+  }
+
+  unsigned length = static_cast<unsigned>(cursor - text);
+  if (length > size)
+    return 0;
+  for (unsigned i = 0; i < length; ++i)
+    buf[i] = static_cast<CharT>(text[i]);
+  return length;
+}
+
+}
+#endif
@@ -35,13 +35,20 @@
 #define CONVERSION_NUMBER_RECOGNIZER_H_
 
 //------ Dependencies ----------------------------------------------------------
+#include "arithmetic.h"
+#include "char_class.h"
+#include "char_scanner.h"
+#include "float_convert.h"
 #include "number_convert.h"
 #include "number_properties.h"
 #include "strto.h"
+#include <algorithm>
 #include <assert.h>
 #include <float.h>
+#include <stdint.h>
+#include <cmath>
 #include <tuple>
-#include <cctype>
+#include <type_traits>
 //------------------------------------------------------------------------------
 
 
@@ -55,10 +62,26 @@ enum Option {
   Prefix0b  = 0x010,    ///< 0b specifies binary base
   Prefix0   = 0x020,    ///< leading 0 specifies octal base
   Floating  = 0x040,    ///< Parse floating point notation
+  HexFloating = 0x080,  ///< Parse hexadecimal float notation after 0x prefix
   DefaultOptions = Floating    ///< Default option set
 };
 
 
+/// Value of recognizer template parameter which means that options are
+/// specified at run time.
+const unsigned DynamicOptions = 0x100;
+
+
+/// Rounding of digits that do not fit fixed point value.
+enum RoundingMode {
+  RoundHalfEven,      ///< To nearest, ties to even value
+  RoundHalfAway,      ///< To nearest, ties away from zero
+  RoundTowardZero,    ///< Discard the digits
+  RoundFloor,         ///< Toward negative infinity
+  RoundCeiling        ///< Toward positive infinity
+};
+
+
 // Allowed bases.
 const unsigned char MinBase = 2;    ///< Minimal allowed base
 const unsigned char MaxBase = 36;   ///< Maximal allowed base
@@ -69,6 +92,319 @@ extern const char upper_digits[];   ///< Upper case digits: 0123456789ABCD...
 extern const char lower_digits[];   ///< Lower case digits: 0123456789abcd...
 
 
+namespace internal {
+
+/// \brief Helper class that appends digits to a number.
+///
+/// \tparam NumType   Target number type.
+/// \tparam IsInteger True if NumType is an integer type.
+///
+/// Methods of the class:
+/// - <tt>safe_digits(base)</tt> returns the number of digits any combination
+///   of which fits NumType, so no overflow check is needed for them;
+/// - <tt>append(value, base, digit)</tt> calculates value * base + digit and
+///   returns true if the result overflows;
+/// - <tt>is_negative_limit(prev, base, digit)</tt> checks if prev * base +
+///   digit is the absolute value of the minimal value of the type.
+///
+template<typename NumType, bool IsInteger>
+class DigitAccumulator;
+
+template<typename NumType>
+class DigitAccumulator<NumType, true> {
+public:
+  static unsigned safe_digits(unsigned base) {
+    if (base == 10)
+      return std::numeric_limits<NumType>::digits10;
+    return std::numeric_limits<NumType>::digits / bit_length(base - 1);
+  }
+
+  static bool append(NumType &value, unsigned base, unsigned digit) {
+    return multiply_add_overflow(value, static_cast<NumType>(base),
+                                 static_cast<NumType>(digit), value);
+  }
+
+  static bool is_negative_limit(NumType prev, unsigned base, unsigned digit) {
+    if (!std::numeric_limits<NumType>::is_signed)
+      return false;
+    typedef typename make_unsigned<NumType>::type UType;
+    UType limit = static_cast<UType>(std::numeric_limits<NumType>::max());
+    ++limit;
+    return (limit - digit) % base == 0 &&
+           (limit - digit) / base == static_cast<UType>(prev);
+  }
+};
+
+template<typename NumType>
+class DigitAccumulator<NumType, false> {
+public:
+  static unsigned safe_digits(unsigned) {
+    return std::numeric_limits<unsigned>::max();
+  }
+
+  static bool append(NumType &value, unsigned base, unsigned digit) {
+    value = value * base + digit;
+    return false;
+  }
+
+  static bool is_negative_limit(NumType, unsigned, unsigned) { return false; }
+};
+
+
+/// \brief Helper class that converts leading decimal digits of a text eight
+/// characters at a time.
+///
+/// \tparam NumType Target number type.
+/// \tparam CharT   Type of character data.
+/// \tparam Enabled True if groups of digits may be used: characters are
+///                 single bytes, the type holds any 8-digit number and is not
+///                 wider than 64 bits.
+///
+/// The class contains static method <tt>convert(value, str, len)</tt>, which
+/// consumes groups of eight digits while the accumulated value is guaranteed
+/// to fit NumType, so no overflow check is needed. Processing stops at the
+/// group that contains a non-digit, the rest is left for the caller.
+///
+template<typename NumType, typename CharT, bool Enabled>
+class DecimalGroups {
+public:
+  static void convert(NumType &, const CharT *&, unsigned &) {}
+};
+
+template<typename NumType, typename CharT>
+class DecimalGroups<NumType, CharT, true> {
+public:
+  static void convert(NumType &value, const CharT *&str, unsigned &len) {
+    assert(value == 0);
+    unsigned safe_digits = std::numeric_limits<NumType>::digits10;
+    uint64_t result = 0;
+    while (len >= 8 && safe_digits >= 8) {
+      uint64_t chars = load_eight_bytes(str);
+      if (!is_eight_digits(chars))
+        break;
+      result = result * 100000000 + parse_eight_digits(chars);
+      str += 8;
+      len -= 8;
+      safe_digits -= 8;
+    }
+    value = static_cast<NumType>(result);
+  }
+};
+
+
+/// \brief Helper class that converts decimal digits to an integer type wider
+/// than 64 bits.
+///
+/// \tparam NumType Target number type.
+/// \tparam CharT   Type of character data.
+/// \tparam Enabled True if NumType is an integer type wider than 64 bits.
+///
+/// The class contains static method <tt>convert(value, str, len)</tt>, which
+/// has the same semantics as convert_int. Digits are accumulated in two 64-bit
+/// limbs of up to 19 digits each, the limbs are joined by single 128-bit
+/// multiplication. So numbers of up to 19 digits do not need 128-bit
+/// arithmetic, and numbers of up to 38 digits, which always fit the type, do
+/// not need overflow checks.
+///
+template<typename NumType, typename CharT, bool Enabled>
+class WideDecimal {
+public:
+  static Status convert(NumType &, const CharT *, unsigned) {
+    assert(false);
+    return NaN;
+  }
+};
+
+template<typename NumType, typename CharT>
+class WideDecimal<NumType, CharT, true> {
+  static_assert(std::numeric_limits<NumType>::digits10 >= 38,
+                "two limbs must fit the type");
+
+  /// Number of digits in a limb.
+  static const unsigned LimbDigits = 19;
+
+  typedef typename make_unsigned<NumType>::type UType;
+
+  // Converts next digits into a limb, at most LimbDigits of them. Leading
+  // digits of narrow string are converted by groups of eight.
+  static bool read_limb(uint64_t &limb, const CharT *&str, unsigned count) {
+    limb = 0;
+    DecimalGroups<uint64_t, CharT, sizeof(CharT) == 1>::convert(limb, str,
+                                                                 count);
+    for (; count; --count, ++str) {
+      unsigned digit = digit_value(*str);
+      if (digit >= 10)
+        return false;
+      limb = limb * 10 + digit;
+    }
+    return true;
+  }
+
+public:
+  static Status convert(NumType &value, const CharT *str, unsigned len) {
+    uint64_t upper;
+    unsigned count = len < LimbDigits ? len : LimbDigits;
+    bool valid = read_limb(upper, str, count);
+    value = static_cast<NumType>(upper);
+    if (!valid)
+      return NaN;
+    len -= count;
+    if (len == 0)
+      return OK;
+
+    uint64_t lower;
+    count = len < LimbDigits ? len : LimbDigits;
+    valid = read_limb(lower, str, count);
+    value = static_cast<NumType>(static_cast<UType>(upper) *
+                                 Power10Integers<>::values[count] + lower);
+    if (!valid)
+      return NaN;
+    len -= count;
+
+    // Digits beyond 38 may make overflow.
+    typedef DigitAccumulator<NumType, true> Accumulator;
+    for (; len; --len, ++str) {
+      unsigned digit = digit_value(*str);
+      if (digit >= 10)
+        return NaN;
+      NumType prev = value;
+      if (Accumulator::append(value, 10, digit)) {
+        if (len == 1 && Accumulator::is_negative_limit(prev, 10, digit))
+          return NegativeLimit;
+        value = std::numeric_limits<NumType>::max();
+        return IntOverflow;
+      }
+    }
+    return OK;
+  }
+};
+
+
+/// \brief Helper class that converts digits in a base that is a power of two
+/// to an integer type by shifts.
+///
+/// \tparam NumType Target number type.
+/// \tparam CharT   Type of character data.
+/// \tparam Enabled True if NumType is an integer type.
+///
+/// The class contains static method <tt>convert(value, str, len, base)</tt>,
+/// which has the same semantics as convert_int. Every digit supplies a fixed
+/// number of bits, so the value is built by shifts, and the number of digits
+/// that cannot make overflow is known from the bit width of the type. Sixteen
+/// leading hexadecimal digits of a narrow string are converted at once. Bits
+/// are collected in 64-bit integer, or in 128-bit one for wider types.
+///
+template<typename NumType, typename CharT, bool Enabled>
+class ShiftDigits {
+public:
+  static Status convert(NumType &, const CharT *, unsigned, unsigned) {
+    assert(false);
+    return NaN;
+  }
+};
+
+template<typename NumType, typename CharT>
+class ShiftDigits<NumType, CharT, true> {
+  static const bool is_signed = std::numeric_limits<NumType>::is_signed;
+  static const unsigned max_bits = std::numeric_limits<NumType>::digits;
+
+  typedef typename std::conditional<
+    (max_bits > 64), typename make_unsigned<NumType>::type, uint64_t
+  >::type Word;
+
+  static Word max() { return std::numeric_limits<NumType>::max(); }
+
+  // Appends digits to the value that has at most max_bits - room significant
+  // bits. Digit width is a template parameter, so that shifts have constant
+  // count.
+  template<unsigned DigitBits>
+  static Status append(NumType &value, Word result, unsigned room,
+                       const CharT *str, unsigned len) {
+    const unsigned base = 1U << DigitBits;
+
+    // Digits that cannot make overflow are appended without check.
+    unsigned safe_len = std::min(len, room / DigitBits);
+    len -= safe_len;
+    for (; safe_len; --safe_len, ++str) {
+      unsigned digit = digit_value(*str);
+      if (digit >= base) {
+        value = static_cast<NumType>(result);
+        return NaN;
+      }
+      result = (result << DigitBits) | digit;
+    }
+
+    // Appending a digit shifts all bits of the value, so overflow is known
+    // before the digit is added.
+    for (; len; --len, ++str) {
+      unsigned digit = digit_value(*str);
+      if (digit >= base) {
+        value = static_cast<NumType>(result);
+        return NaN;
+      }
+      if (result > (max() >> DigitBits)) {
+        // Check particular case, if this is negation of negative limit.
+        if (is_signed && len == 1 && digit == 0 &&
+            result == (max() >> DigitBits) + 1) {
+          value = static_cast<NumType>(max());
+          return NegativeLimit;
+        }
+        value = static_cast<NumType>(max());
+        return IntOverflow;
+      }
+      result = (result << DigitBits) | digit;
+    }
+
+    value = static_cast<NumType>(result);
+    return OK;
+  }
+
+  // Converts at least sixteen hexadecimal digits of a narrow string, leading
+  // sixteen of them are converted by vectorized code. Shorter texts are
+  // converted digit by digit, a branch on their length would cost more than
+  // the vectorized code saves.
+  static Status convert_long_hex(NumType &value, const char *str,
+                                 unsigned len) {
+    uint64_t result = 0;
+    unsigned room = max_bits;
+    if (parse_sixteen_hex_digits(str, result)) {
+      str += 16;
+      len -= 16;
+      if (result > max()) {
+        if (is_signed && len == 0 && result - 1 == max())
+          return NegativeLimit;
+        value = static_cast<NumType>(max());
+        return IntOverflow;
+      }
+      if (result)
+        room -= bit_length(result);
+    }
+    return append<4>(value, result, room, reinterpret_cast<const CharT *>(str),
+                     len);
+  }
+
+public:
+  static Status convert(NumType &value, const CharT *str, unsigned len,
+                        unsigned base) {
+    switch (base) {
+    case 2: return append<1>(value, 0, max_bits, str, len);
+    case 4: return append<2>(value, 0, max_bits, str, len);
+    case 8: return append<3>(value, 0, max_bits, str, len);
+    case 16:
+      if (sizeof(CharT) == 1 && len >= 16)
+        return convert_long_hex(value, reinterpret_cast<const char *>(str),
+                                len);
+      return append<4>(value, 0, max_bits, str, len);
+    default:
+      assert(base == 32);
+      return append<5>(value, 0, max_bits, str, len);
+    }
+  }
+};
+
+}
+
+
 /// \brief Converts sequence of digits into corresponding integer number.
 ///
 /// \tparam NumType Target number type.
@@ -94,42 +430,52 @@ Status convert_int(NumType &value, const CharT *str, unsigned len,
   assert(str);
   assert(base >= MinBase && base <= MaxBase);
 
-  // Build result value.
-  for (; len; --len, ++str) {
-    // Get current digit
-    CharT ch = *str;
-    unsigned char digit;
-    if (ch >= CharT('0') && ch <= CharT('9'))
-      digit = ch - CharT('0');
-    else if (ch >= CharT('A') && ch <= CharT('Z'))
-      digit = 10 + (ch - CharT('A'));
-    else if (ch >= CharT('a') && ch <= CharT('z'))
-      digit = 10 + (ch - CharT('a'));
-    else
+  // Bases 2, 4, 8, 16 and 32 do not need multiplication.
+  if ((base & (base - 1)) == 0 && std::numeric_limits<NumType>::is_integer)
+    return internal::ShiftDigits<NumType, CharT,
+      std::numeric_limits<NumType>::is_integer>::convert(value, str, len, base);
+
+  // Integer types wider than 64 bits collect decimal digits in 64-bit parts.
+  const bool is_wide_int = std::numeric_limits<NumType>::is_integer &&
+                           std::numeric_limits<NumType>::digits > 64;
+  if (base == 10 && is_wide_int)
+    return internal::WideDecimal<NumType, CharT, is_wide_int>::convert(
+      value, str, len);
+
+  typedef internal::DigitAccumulator<
+    NumType, std::numeric_limits<NumType>::is_integer> Accumulator;
+  unsigned safe_len = Accumulator::safe_digits(base);
+
+  // Leading decimal digits are processed by groups.
+  if (base == 10) {
+    unsigned initial_len = len;
+    internal::DecimalGroups<NumType, CharT,
+      sizeof(CharT) == 1 && std::numeric_limits<NumType>::is_integer &&
+      std::numeric_limits<NumType>::digits10 >= 8 &&
+      std::numeric_limits<NumType>::digits <= 64>::convert(value, str, len);
+    safe_len -= initial_len - len;
+  }
+
+  // Build result value. First digits cannot make overflow, so they are
+  // appended without check.
+  for (; len && safe_len; --len, ++str, --safe_len) {
+    unsigned char digit = internal::digit_value(*str);
+    if (digit >= base)
       return NaN;
+    value = static_cast<NumType>(value * base + digit);
+  }
+
+  for (; len; --len, ++str) {
+    unsigned char digit = internal::digit_value(*str);
     if (digit >= base)
       return NaN;
 
     // Append the digit to result.
     NumType prev = value;
-    value *= base;
-    // TODO: there must be more effective way to detect overflow, for instance
-    // by using compiler intrinsics.
-    bool overflow = false;
-    if (std::numeric_limits<NumType>::is_integer)
-      overflow = (value / base != prev);
-    if (!overflow) {
-      value += digit;
-      if (value < prev)
-        overflow = true;
-    }
-    if (overflow) {
-      if (std::numeric_limits<NumType>::is_integer &&
-          std::numeric_limits<NumType>::is_signed && len == 1) {
-        // Check particular case, if this is negation of negative limit.
-        if (prev * base - 1 + digit == std::numeric_limits<NumType>::max())
-          return NegativeLimit;
-      }
+    if (Accumulator::append(value, base, digit)) {
+      // Check particular case, if this is negation of negative limit.
+      if (len == 1 && Accumulator::is_negative_limit(prev, base, digit))
+        return NegativeLimit;
       value = std::numeric_limits<NumType>::max();
       return IntOverflow;
     }
@@ -148,7 +494,395 @@ Status convert_int(NumType &value, std::tuple<const CharT *, unsigned> text,
 }
 
 
+namespace internal {
+
+/// Maximal absolute value of exponent. Larger values are limited by it, so
+/// that adding number of digits in mantissa cannot overflow int. Such exponent
+/// anyway makes the value either zero or infinity.
+const int MaxExponent = 100000000;
+
+
+/// \brief Converts digits of exponent to its absolute value, limited by
+/// MaxExponent.
+///
+template<typename CharT>
+int read_exponent(std::tuple<const CharT *, unsigned> digits) {
+  int expval;
+  Status st = convert_int(expval, digits);
+  if (st != OK || expval > MaxExponent)
+    expval = MaxExponent;
+  return expval;
+}
+
+
+/// \brief Converts decimal number written in float notation to an integer
+/// type.
+///
+/// \param value       Receives absolute value of the integer part.
+/// \param int_digits  Digits of integer part.
+/// \param frac_digits Digits of fractional part.
+/// \param exponent    Decimal exponent.
+/// \param inexact     Set to true if nonzero digits of fractional part are
+///                    discarded.
+///
+/// The exponent moves the decimal point, so the integer part is made of the
+/// digits that precede the new point position, followed by zeros if the point
+/// moves past the last digit. The digits are accumulated exactly, without
+/// floating point calculations. Overflow is reported as by convert_int.
+///
+template<typename NumType, typename CharT>
+Status convert_float_int(NumType &value,
+                         std::tuple<const CharT *, unsigned> int_digits,
+                         std::tuple<const CharT *, unsigned> frac_digits,
+                         int exponent, bool &inexact) {
+  typedef DigitAccumulator<
+    NumType, std::numeric_limits<NumType>::is_integer> Accumulator;
+  const CharT *int_str = std::get<0>(int_digits);
+  unsigned int_len = std::get<1>(int_digits);
+  const CharT *frac_str = std::get<0>(frac_digits);
+  unsigned frac_len = std::get<1>(frac_digits);
+  value = 0;
+  inexact = false;
+
+  // Number of digits before the point, counting from the first nonzero one.
+  long long point = static_cast<long long>(int_len) + exponent;
+  while (int_len && *int_str == CharT('0')) {
+    ++int_str;
+    --int_len;
+    --point;
+  }
+  if (int_len == 0) {
+    while (frac_len && *frac_str == CharT('0')) {
+      ++frac_str;
+      --frac_len;
+      --point;
+    }
+    if (frac_len == 0)
+      return OK;
+  }
+
+  if (point <= 0) {
+    inexact = true;
+    return OK;
+  }
+  if (point > std::numeric_limits<NumType>::digits10 + 1) {
+    value = std::numeric_limits<NumType>::max();
+    return IntOverflow;
+  }
+
+  // If the integer part has at most digits10 digits, it cannot overflow, and
+  // digits of both parts are appended without check.
+  if (point <= std::numeric_limits<NumType>::digits10) {
+    unsigned count = static_cast<unsigned>(point);
+    unsigned int_used = std::min(int_len, count);
+    unsigned frac_used = std::min(frac_len, count - int_used);
+    for (unsigned i = 0; i < int_used; ++i)
+      value = static_cast<NumType>(value * 10 + (int_str[i] - '0'));
+    for (unsigned i = 0; i < frac_used; ++i)
+      value = static_cast<NumType>(value * 10 + (frac_str[i] - '0'));
+    for (unsigned i = int_used + frac_used; i < count; ++i)
+      value = static_cast<NumType>(value * 10);
+    for (unsigned i = int_used; i < int_len && !inexact; ++i)
+      inexact = int_str[i] != CharT('0');
+    for (unsigned i = frac_used; i < frac_len && !inexact; ++i)
+      inexact = frac_str[i] != CharT('0');
+    return OK;
+  }
+
+  Status result = OK;
+  unsigned num_digits = int_len + frac_len;
+  for (unsigned i = 0; i < num_digits; ++i) {
+    unsigned digit = (i < int_len ? int_str[i] : frac_str[i - int_len]) - '0';
+    if (i >= point) {
+      if (digit)
+        inexact = true;
+      continue;
+    }
+    NumType prev = value;
+    if (Accumulator::append(value, 10, digit)) {
+      if (i + 1 != point || !Accumulator::is_negative_limit(prev, 10, digit)) {
+        value = std::numeric_limits<NumType>::max();
+        return IntOverflow;
+      }
+      result = NegativeLimit;
+    }
+  }
+  for (long long i = num_digits; i < point; ++i) {
+    NumType prev = value;
+    if (Accumulator::append(value, 10, 0)) {
+      if (i + 1 == point && Accumulator::is_negative_limit(prev, 10, 0))
+        return NegativeLimit;
+      value = std::numeric_limits<NumType>::max();
+      return IntOverflow;
+    }
+  }
+  return result;
+}
+
+
+
+/// \brief Compares the digits discarded by convert_float_int with half of the
+/// unit in the last place of the result.
+///
+/// \param int_digits  Digits of integer part.
+/// \param frac_digits Digits of fractional part.
+/// \param exponent    Decimal exponent, as passed to convert_float_int.
+///
+/// \returns Negative value, zero or positive value if the discarded part is
+/// less than, equal to or greater than half of the unit. The discarded digits
+/// must not be all zeros.
+///
+template<typename CharT>
+int compare_discarded_to_half(std::tuple<const CharT *, unsigned> int_digits,
+                              std::tuple<const CharT *, unsigned> frac_digits,
+                              int exponent) {
+  const CharT *int_str = std::get<0>(int_digits);
+  unsigned int_len = std::get<1>(int_digits);
+  const CharT *frac_str = std::get<0>(frac_digits);
+  unsigned num_digits = int_len + std::get<1>(frac_digits);
+
+  // If the point precedes all digits, the first discarded digit is zero.
+  long long point = static_cast<long long>(int_len) + exponent;
+  if (point < 0 || point >= num_digits)
+    return -1;
+  unsigned pos = static_cast<unsigned>(point);
+  CharT first = pos < int_len ? int_str[pos] : frac_str[pos - int_len];
+  if (first != CharT('5'))
+    return first < CharT('5') ? -1 : 1;
+  for (++pos; pos < num_digits; ++pos) {
+    CharT digit = pos < int_len ? int_str[pos] : frac_str[pos - int_len];
+    if (digit != CharT('0'))
+      return 1;
+  }
+  return 0;
+}
+
+
+/// \brief Checks if the absolute value truncated by convert_float_int must be
+/// incremented.
+///
+/// \param mode     Rounding mode.
+/// \param negative True if the number is negative.
+/// \param odd      True if the truncated absolute value is odd.
+/// \param half_cmp Result of compare_discarded_to_half.
+///
+inline bool rounds_away(RoundingMode mode, bool negative, bool odd,
+                        int half_cmp) {
+  switch (mode) {
+  case RoundHalfEven:
+    return half_cmp > 0 || (half_cmp == 0 && odd);
+  case RoundHalfAway:
+    return half_cmp >= 0;
+  case RoundFloor:
+    return negative;
+  case RoundCeiling:
+    return !negative;
+  default:
+    return false;
+  }
+}
+
+
+/// \brief Converts number written in hexadecimal float notation to an integer
+/// type.
+///
+/// \param value       Receives absolute value of the integer part.
+/// \param int_digits  Hexadecimal digits of integer part.
+/// \param frac_digits Hexadecimal digits of fractional part.
+/// \param exponent    Binary exponent.
+/// \param inexact     Set to true if nonzero bits of fractional part are
+///                    discarded.
+///
+/// This is the binary counterpart of convert_float_int: the exponent moves the
+/// binary point, bits that precede it are accumulated one by one.
+///
+template<typename NumType, typename CharT>
+Status convert_hex_float_int(NumType &value,
+                             std::tuple<const CharT *, unsigned> int_digits,
+                             std::tuple<const CharT *, unsigned> frac_digits,
+                             int exponent, bool &inexact) {
+  typedef DigitAccumulator<
+    NumType, std::numeric_limits<NumType>::is_integer> Accumulator;
+  const CharT *int_str = std::get<0>(int_digits);
+  unsigned int_len = std::get<1>(int_digits);
+  const CharT *frac_str = std::get<0>(frac_digits);
+  unsigned frac_len = std::get<1>(frac_digits);
+  value = 0;
+  inexact = false;
+
+  // Number of bits before the point, counting from the first nonzero digit.
+  long long point = 4 * static_cast<long long>(int_len) + exponent;
+  while (int_len && *int_str == CharT('0')) {
+    ++int_str;
+    --int_len;
+    point -= 4;
+  }
+  if (int_len == 0) {
+    while (frac_len && *frac_str == CharT('0')) {
+      ++frac_str;
+      --frac_len;
+      point -= 4;
+    }
+    if (frac_len == 0)
+      return OK;
+  }
+
+  if (point <= 0) {
+    inexact = true;
+    return OK;
+  }
+  // The first digit may have up to three leading zero bits.
+  if (point > std::numeric_limits<NumType>::digits + 4) {
+    value = std::numeric_limits<NumType>::max();
+    return IntOverflow;
+  }
+
+  Status result = OK;
+  long long num_bits = 4 * static_cast<long long>(int_len + frac_len);
+  for (long long i = 0; i < num_bits; ++i) {
+    unsigned pos = static_cast<unsigned>(i / 4);
+    unsigned digit = digit_value(pos < int_len ? int_str[pos]
+                                               : frac_str[pos - int_len]);
+    unsigned bit = (digit >> (3 - i % 4)) & 1;
+    if (i >= point) {
+      if (bit) {
+        inexact = true;
+        break;
+      }
+      continue;
+    }
+    NumType prev = value;
+    if (Accumulator::append(value, 2, bit)) {
+      if (i + 1 != point || !Accumulator::is_negative_limit(prev, 2, bit)) {
+        value = std::numeric_limits<NumType>::max();
+        return IntOverflow;
+      }
+      result = NegativeLimit;
+    }
+  }
+  for (long long i = num_bits; i < point; ++i) {
+    NumType prev = value;
+    if (Accumulator::append(value, 2, 0)) {
+      if (i + 1 == point && Accumulator::is_negative_limit(prev, 2, 0))
+        return NegativeLimit;
+      value = std::numeric_limits<NumType>::max();
+      return IntOverflow;
+    }
+  }
+  return result;
+}
+
+
+/// \brief Converts digits of an integer in base 2, 8 or 16 to a float type.
+///
+/// Digits are collected in 64-bit integer, digits that do not fit it only
+/// set its lowest bit (rounding to odd). The integer has then at least 60
+/// significant bits, so the following conversion to FloatT is rounded
+/// correctly.
+///
+template<typename FloatT, typename CharT>
+Status convert_power2_int(FloatT &value,
+                          std::tuple<const CharT *, unsigned> digits,
+                          unsigned base, bool negative) {
+  static_assert(std::numeric_limits<FloatT>::digits <= 58,
+                "Too wide float type");
+  assert(base == 2 || base == 8 || base == 16);
+  const unsigned digit_bits = base == 16 ? 4 : base == 8 ? 3 : 1;
+  const int MaxShift = 2 * std::numeric_limits<FloatT>::max_exponent;
+
+  const CharT *cursor = std::get<0>(digits);
+  const CharT *end = cursor + std::get<1>(digits);
+  uint64_t mantissa = 0;
+  int shift = 0;
+  bool sticky = false;
+  for (; cursor != end; ++cursor) {
+    unsigned digit = digit_value(*cursor);
+    if (digit >= base) {
+      value = 0;
+      return NaN;
+    }
+    if ((mantissa >> (64 - digit_bits)) == 0) {
+      mantissa = (mantissa << digit_bits) | digit;
+    } else {
+      if (shift < MaxShift)
+        shift += digit_bits;
+      sticky |= digit != 0;
+    }
+  }
+  if (sticky)
+    mantissa |= 1;
+
+  FloatT result = std::ldexp(static_cast<FloatT>(mantissa), shift);
+  if (result > std::numeric_limits<FloatT>::max())
+    return set_float_overflow(value, negative);
+  value = negative ? -result : result;
+  return OK;
+}
+
+
+/// \brief Applies sign to the absolute value obtained by convert_int.
+///
+/// Values out of range of the integer type are saturated, and status is set
+/// as convert_to does it for number to number conversions. Positive value
+/// equal to the absolute value of the minimal one gets status NegativeLimit.
+///
+template<typename NumberType, bool IsInt, bool Signed>
+class SetSign;
+
+
+template<typename NumberType>
+class SetSign<NumberType, true, true> {
+public:
+  static void set(NumberType &value, bool is_negative, Status &status) {
+    if (is_negative) {
+      if (status == NegativeLimit) {
+        value = std::numeric_limits<NumberType>::min();
+        status = OK;
+      } else if (status == IntOverflow) {
+        value = std::numeric_limits<NumberType>::min();
+        status = IntOverflowNegative;
+      } else {
+        value = -value;
+      }
+    }
+    else if (status == NegativeLimit) {
+      value = std::numeric_limits<NumberType>::max();
+    }
+  }
+};
+
+
+template<typename NumberType>
+class SetSign<NumberType, true, false> {
+public:
+  static void set(NumberType &value, bool is_negative, Status &status) {
+    assert(status != NegativeLimit);
+    if (is_negative) {
+      // Negative values are out of range, except for zero.
+      if (value != 0 || status == IntOverflow)
+        status = IntOverflowNegative;
+      value = 0;
+    }
+  }
+};
+
+
+template<typename NumberType>
+class SetSign<NumberType, false, true> {
+public:
+  static void set(NumberType &value, bool is_negative, Status &status) {
+    if (is_negative)
+      value = -value;
+  }
+};
+
+}
+
+
+class CompactRecognizerState;
+
 class NumberRecognizerState {
+  friend class CompactRecognizerState;
 public:
 
   // Recognizer options.
@@ -164,6 +898,7 @@ public:
   bool is_allowed_0b() const { return (options & Prefix0b) != 0; }
   bool is_allowed_0() const { return (options & Prefix0) != 0; }
   bool is_allowed_float() const { return (options & Floating) != 0; }
+  bool is_allowed_hex_float() const { return (options & HexFloating) != 0; }
 
   void set_base(unsigned char x) { base = x; }
 
@@ -195,6 +930,10 @@ public:
   bool is_float() const { return has_dot || exp_length; }
   bool is_empty() const { return leading_ws == length; }
 
+  /// \brief Returns true if the number is written in hexadecimal float
+  /// notation. Its exponent is then a power of 2 rather than of 10.
+  bool has_binary_exp() const { return base == 16 && is_float(); }
+
   // Number parts.
 
   unsigned get_leading_ws() const { return leading_ws; }
@@ -291,72 +1030,433 @@ protected:
   }
 
   Result get_result() const { return static_cast<Result>(result); }
-};
 
+  template<typename NumType>
+  void set_sign(NumType &value, bool is_neg, Status &st) {
+    internal::SetSign<
+      NumType,
+      std::numeric_limits<NumType>::is_integer,
+      std::numeric_limits<NumType>::is_signed
+    >::set(value, is_neg, st);
+    status = st;
+  }
 
-namespace internal {
+  /// \brief Converts recognized number to the specified type.
+  ///
+  /// \param value       Receives the result.
+  /// \param int_digits  Digits of integer part.
+  /// \param frac_digits Digits of fractional part.
+  /// \param expval      Absolute value of exponent.
+  /// \param scale       Decimal exponent by which float conversion additionally
+  ///                    scales the digits.
+  /// \param is_float_text True if the number is written in float notation.
+  /// \param num_base    Base of the number.
+  ///
+  template<typename NumType, typename CharT>
+  Status convert_parts(NumType &value,
+                       std::tuple<const CharT *, unsigned> int_digits,
+                       std::tuple<const CharT *, unsigned> frac_digits,
+                       int expval, int scale, bool is_float_text,
+                       unsigned num_base) {
+    // If the recognized number contains only integer part, convert
+    // corresponding sequence of digits. Numbers read into a float type are
+    // converted below, as it provides correct rounding.
+    if (!is_float_text && std::numeric_limits<NumType>::is_integer) {
+      Status st = convert_int(value, int_digits, num_base);
+      set_sign(value, is_negative(), st);
+      return st;
+    }
 
-template<typename NumberType, bool IsInt, bool Signed>
-class SetSign;
+    if (is_exp_negative())
+      expval = -expval;
 
+    // If NumType is an integer type, make exact conversion to integer. The
+    // fractional part is truncated.
+    if (std::numeric_limits<NumType>::is_integer) {
+      bool inexact;
+      Status st = num_base == 16
+        ? internal::convert_hex_float_int(value, int_digits, frac_digits,
+                                          expval, inexact)
+        : internal::convert_float_int(value, int_digits, frac_digits,
+                                      expval + scale, inexact);
+      set_sign(value, is_negative(), st);
+      if (st == OK && inexact)
+        status = st = DoubleToInt;
+      return st;
+    }
 
-template<typename NumberType>
-class SetSign<NumberType, true, true> {
-public:
-  static void set(NumberType &value, bool is_negative, Status &status) {
-    if (is_negative) {
-      if (status == NegativeLimit) {
-        value = std::numeric_limits<NumberType>::min();
-        status = OK;
-      } else {
-        value = -value;
+    // Textual representation of a float value is converted to float data type.
+
+    // Convert text to number. Values of type float are built directly from
+    // the recognized digits, other types are obtained from double.
+    typedef typename std::conditional<
+      std::is_same<NumType, float>::value, float, double>::type FloatType;
+    FloatType fvalue;
+    Status st;
+    if (num_base == 10)
+      st = convert_float(fvalue, int_digits, frac_digits, expval + scale,
+                         is_negative());
+    else if (is_float_text)
+      st = convert_hex_float(fvalue, int_digits, frac_digits, expval,
+                             is_negative());
+    else
+      st = internal::convert_power2_int(fvalue, int_digits, num_base,
+                                        is_negative());
+    auto res = convert_to<NumType>(fvalue);
+    value = res.value();
+    if (st != OK)
+      status = st;
+    else if (res.ok())
+      status = Status::OK;
+    else
+      status = res.status();
+    return static_cast<Status>(status);
+  }
+
+  /// \brief Converts recognized number to an integer that counts units of
+  /// 10^-scale.
+  ///
+  /// \param value       Receives the result.
+  /// \param int_digits  Digits of integer part.
+  /// \param frac_digits Digits of fractional part.
+  /// \param expval      Absolute value of exponent.
+  /// \param scale       Number of decimal digits after the point that the
+  ///                    result keeps.
+  /// \param num_base    Base of the number.
+  /// \param mode        Rounding of the digits beyond the scale.
+  ///
+  /// Decimal numbers are converted by convert_float_int with the exponent
+  /// increased by the scale, then the discarded digits are rounded. Integers
+  /// in other bases are multiplied by the power of ten. Numbers in hexadecimal
+  /// float notation are not supported.
+  ///
+  template<typename NumType, typename CharT>
+  Status convert_fixed(NumType &value,
+                       std::tuple<const CharT *, unsigned> int_digits,
+                       std::tuple<const CharT *, unsigned> frac_digits,
+                       int expval, unsigned scale, unsigned num_base,
+                       RoundingMode mode) {
+    static_assert(std::numeric_limits<NumType>::is_integer,
+                  "fixed point value must have integer type");
+    typedef internal::DigitAccumulator<NumType, true> Accumulator;
+    const NumType max_value = std::numeric_limits<NumType>::max();
+    Status st;
+    bool inexact = false;
+
+    if (num_base != 10) {
+      if (has_binary_exp()) {
+        value = 0;
+        return static_cast<Status>(status = NaN);
+      }
+      st = convert_int(value, int_digits, num_base);
+      // Absolute value of the minimal one cannot be scaled without overflow.
+      if (st == NegativeLimit && scale > 0) {
+        value = max_value;
+        st = IntOverflow;
+      }
+      for (unsigned i = 0; i < scale && st == OK; ++i) {
+        NumType prev = value;
+        if (Accumulator::append(value, 10, 0)) {
+          if (i + 1 == scale && Accumulator::is_negative_limit(prev, 10, 0)) {
+            st = NegativeLimit;
+          } else {
+            value = max_value;
+            st = IntOverflow;
+          }
+        }
+      }
+    } else {
+      if (is_exp_negative())
+        expval = -expval;
+      int exponent = expval + static_cast<int>(scale);
+      st = internal::convert_float_int(value, int_digits, frac_digits,
+                                       exponent, inexact);
+      if (inexact && st != IntOverflow &&
+          internal::rounds_away(mode, is_negative(), value % 2 != 0,
+            internal::compare_discarded_to_half(int_digits, frac_digits,
+                                                exponent))) {
+        // Incremented value may be absolute value of the minimal one.
+        if (st == NegativeLimit) {
+          value = max_value;
+          st = IntOverflow;
+        } else if (value == max_value) {
+          st = std::numeric_limits<NumType>::is_signed ? NegativeLimit
+                                                       : IntOverflow;
+        } else {
+          ++value;
+        }
       }
     }
-    else if (status == NegativeLimit) {
-      value = std::numeric_limits<NumberType>::max();
-    }
+
+    set_sign(value, is_negative(), st);
+    // Positive value equal to the absolute value of the minimal one does not
+    // fit the type.
+    if (st == NegativeLimit)
+      st = IntOverflow;
+    else if (st == OK && inexact)
+      st = DoubleToInt;
+    status = st;
+    return st;
   }
 };
 
 
-template<typename NumberType>
-class SetSign<NumberType, true, false> {
+/// \brief Results of number recognition packed into 16 bytes.
+///
+/// The class keeps the same data as NumberRecognizerState, except options and
+/// conversion status, in compact form, so that results of recognition of many
+/// numbers may be kept in arrays for later conversion. Offsets are stored as
+/// 16-bit numbers, so the text must be shorter than 64K characters. Besides,
+/// sign, prefix and leading zeros together may take up to 255 characters,
+/// exponent may have up to 31 leading zeros and 255 significant digits. Other
+/// parts of the state are calculated from the stored ones.
+///
+/// Accessors of the recognition results have the same names as those of
+/// NumberRecognizerState.
+///
+class CompactRecognizerState {
 public:
-  static void set(NumberType &value, bool is_negative, Status &status) {
-    assert(status != NegativeLimit);
-    if (is_negative)
-      value = 0;
+  CompactRecognizerState()
+    : length(0), leading_ws(0), int_length(0), frac_length(0), exp_start(0),
+      rest_start(0), int_offset(0), exp_length(0), exp_leading_zeros(0),
+      has_dot(0), has_prefix(0), sign(0), exp_sign(0), base_code(0),
+      result(0) {}
+
+  /// \brief Checks if the state can be represented in compact form.
+  static bool fits(const NumberRecognizerState &state) {
+    if (state.length > 0xFFFF || encode_base(state.base) < 0 ||
+        state.exp_leading_zeros > 31 || state.exp_length > 0xFF)
+      return false;
+    if (state.int_start < state.leading_ws ||
+        state.int_start - state.leading_ws > 0xFF ||
+        state.frac_start != state.int_start + state.int_length +
+                            state.has_dot)
+      return false;
+    return state.trailing_ws ==
+           get_trailing_ws(state.result, state.exp_start, state.exp_length,
+                           state.rest_start);
   }
-};
 
+  /// \brief Stores the state in compact form.
+  ///
+  /// \returns False if the state cannot be represented in compact form, in
+  ///          this case the object is not changed.
+  ///
+  bool assign(const NumberRecognizerState &state) {
+    if (!fits(state))
+      return false;
+    length = static_cast<uint16_t>(state.length);
+    leading_ws = static_cast<uint16_t>(state.leading_ws);
+    int_length = static_cast<uint16_t>(state.int_length);
+    frac_length = static_cast<uint16_t>(state.frac_length);
+    exp_start = static_cast<uint16_t>(state.exp_start);
+    rest_start = static_cast<uint16_t>(state.rest_start);
+    int_offset = static_cast<uint8_t>(state.int_start - state.leading_ws);
+    exp_length = static_cast<uint8_t>(state.exp_length);
+    exp_leading_zeros = state.exp_leading_zeros;
+    has_dot = state.has_dot;
+    has_prefix = state.has_prefix;
+    sign = state.sign;
+    exp_sign = state.exp_sign;
+    base_code = static_cast<uint16_t>(encode_base(state.base));
+    result = state.result;
+    return true;
+  }
 
-template<typename NumberType>
-class SetSign<NumberType, false, true> {
-public:
-  static void set(NumberType &value, bool is_negative, Status &status) {
-    if (is_negative)
-      value = -value;
+  /// \brief Restores the full state.
+  ///
+  /// \param state Receives the recognition results.
+  /// \param opts  Recognizer options.
+  ///
+  /// Conversion status is set as the recognizer leaves it.
+  ///
+  void restore(NumberRecognizerState &state,
+               unsigned char opts = DefaultOptions) const {
+    state.init(opts);
+    state.length = length;
+    state.leading_ws = leading_ws;
+    state.int_start = get_int_start();
+    state.int_length = int_length;
+    state.frac_start = get_frac_start();
+    state.frac_length = frac_length;
+    state.exp_start = exp_start;
+    state.exp_leading_zeros = exp_leading_zeros;
+    state.exp_length = exp_length;
+    state.trailing_ws = get_trailing_ws();
+    state.rest_start = rest_start;
+    state.has_dot = has_dot;
+    state.has_prefix = has_prefix;
+    state.sign = sign;
+    state.exp_sign = exp_sign;
+    state.base = get_base();
+    state.result = result;
+    state.status = failure() ? NaN : OK;
+  }
+
+  unsigned size() const { return length; }
+
+  // Recognition results.
+
+  bool has_sign() const { return sign != NoSign; }
+  bool has_plus() const { return sign == Positive; }
+  bool has_minus() const { return sign == Negative; }
+  bool is_positive() const { return sign <= Positive; }
+  bool is_negative() const { return sign == Negative; }
+
+  bool has_exp_sign() const { return exp_sign != NoSign; }
+  bool has_exp_plus() const { return exp_sign == Positive; }
+  bool has_exp_minus() const { return exp_sign == Negative; }
+  bool is_exp_positive() const { return exp_sign <= Positive; }
+  bool is_exp_negative() const { return exp_sign == Negative; }
+
+  bool recognized() const { return result != Unrecognized; }
+  bool success() const { return result == Success; }
+  bool failure() const { return result == Failure; }
+  bool partial() const { return result == Partial; }
+
+  unsigned get_base() const { return decode_base(base_code); }
+
+  bool is_float() const { return has_dot || exp_length; }
+  bool is_empty() const { return leading_ws == length; }
+  bool has_binary_exp() const { return get_base() == 16 && is_float(); }
+
+  // Number parts.
+
+  unsigned get_leading_ws() const { return leading_ws; }
+  unsigned get_leading_zeros() const {
+    if (int_length == 0)
+      return 0;
+    return get_int_start() - leading_ws - get_prefix_length() - has_sign();
+  }
+  unsigned get_prefix_length() const { return has_prefix ? has_sign() + 2 : 0; }
+  unsigned get_trailing_zeros() const {
+    unsigned frac_end = get_frac_start() + frac_length;
+    if (exp_length)
+      return (exp_start - (1 + has_exp_sign() + exp_leading_zeros)) - frac_end;
+    return exp_start - frac_end;
+  }
+  unsigned get_trailing_ws() const {
+    return get_trailing_ws(result, exp_start, exp_length, rest_start);
+  }
+
+  unsigned get_int_length() const { return int_length; }
+  unsigned get_frac_length() const { return frac_length; }
+  unsigned get_exp_length() const { return exp_length; }
+  unsigned get_rest_length() const { return length - rest_start; }
+  unsigned get_mantissa_length() const {
+    return int_length + frac_length + (has_dot && frac_length);
+  }
+  unsigned get_number_length() const {
+    return rest_start - leading_ws - get_trailing_ws();
+  }
+
+  unsigned get_prefix_start() const { return leading_ws + has_sign(); }
+  unsigned get_int_start() const { return leading_ws + int_offset; }
+  unsigned get_frac_start() const {
+    return get_int_start() + int_length + has_dot;
+  }
+  unsigned get_exp_start() const { return exp_start; }
+  unsigned get_rest_start() const { return rest_start; }
+  unsigned get_mantissa_start() const { return get_int_start(); }
+  unsigned get_number_start() const { return leading_ws; }
+
+private:
+  typedef NumberRecognizerState State;
+  static const unsigned Unrecognized = State::Unrecognized;
+  static const unsigned Success = State::Success;
+  static const unsigned Partial = State::Partial;
+  static const unsigned Failure = State::Failure;
+  static const unsigned NoSign = State::NoSign;
+  static const unsigned Positive = State::Positive;
+  static const unsigned Negative = State::Negative;
+
+  uint16_t length;
+  uint16_t leading_ws;
+  uint16_t int_length;
+  uint16_t frac_length;
+  uint16_t exp_start;
+  uint16_t rest_start;
+  uint8_t int_offset;           ///< Start of integer part in the number
+  uint8_t exp_length;
+  uint16_t exp_leading_zeros : 5;
+  uint16_t has_dot : 1;
+  uint16_t has_prefix : 1;
+  uint16_t sign : 2;
+  uint16_t exp_sign : 2;
+  uint16_t base_code : 3;
+  uint16_t result : 2;
+
+  static int encode_base(unsigned base) {
+    switch (base) {
+    case 0: return 0;
+    case 2: return 1;
+    case 8: return 2;
+    case 10: return 3;
+    case 16: return 4;
+    default: return -1;
+    }
+  }
+
+  static unsigned decode_base(unsigned code) {
+    static const unsigned char bases[] = { 0, 2, 8, 10, 16 };
+    return bases[code];
+  }
+
+  /// Trailing spaces follow the exponent or mantissa, if a number is found.
+  static unsigned get_trailing_ws(unsigned result, unsigned exp_start,
+                                  unsigned exp_length, unsigned rest_start) {
+    if (result != Success && result != Partial)
+      return 0;
+    return rest_start - exp_start - exp_length;
   }
 };
 
-}
+static_assert(sizeof(CompactRecognizerState) == 16,
+              "CompactRecognizerState must occupy 16 bytes");
 
-template<typename CharT = char, typename TraitT = std::char_traits<CharT> >
+
+/// \brief Recognizes a number in text and converts it to numeric types.
+///
+/// \tparam CharT     Character type.
+/// \tparam TraitT    Character traits.
+/// \tparam FixedOptions Recognizer options known at compile time, or
+///                   DynamicOptions if they are specified at run time.
+/// \tparam FixedBase Base of the number known at compile time, or 0 if it is
+///                   specified at run time or is determined by prefix.
+///
+/// If options or base are fixed, the compiler removes unused branches of the
+/// recognizer, so that each configuration gets specialized parser. Options
+/// and base set at run time are ignored in this case.
+///
+template<typename CharT = char, typename TraitT = std::char_traits<CharT>,
+         unsigned FixedOptions = DynamicOptions, unsigned char FixedBase = 0>
 class NumberRecognizer : public NumberRecognizerState {
+  static_assert(FixedOptions == DynamicOptions || FixedOptions < 0x100,
+                "invalid recognizer options");
+  static_assert(FixedBase == 0 || FixedBase == 2 || FixedBase == 8 ||
+                FixedBase == 10 || FixedBase == 16, "invalid base");
+
+  static const unsigned char InitialOptions =
+    FixedOptions == DynamicOptions ? static_cast<unsigned char>(DefaultOptions)
+                                   : FixedOptions;
+
   const CharT *start;
 public:
 
   // Constructors.
 
-  NumberRecognizer() { start = nullptr; }
+  NumberRecognizer() : NumberRecognizerState(InitialOptions) {
+    start = nullptr;
+  }
   NumberRecognizer(unsigned opts) : NumberRecognizerState(opts) {
     start = nullptr;
   }
-  NumberRecognizer(const CharT *str) : NumberRecognizerState(), start(str) {
+  NumberRecognizer(const CharT *str)
+    : NumberRecognizerState(InitialOptions), start(str) {
     length = TraitT::length(str);
   }
   NumberRecognizer(const CharT *str, unsigned len)
-    : NumberRecognizerState(), start(str) {
+    : NumberRecognizerState(InitialOptions), start(str) {
     length = len;
   }
   NumberRecognizer(const CharT *str, unsigned len, unsigned opts)
@@ -366,7 +1466,7 @@ public:
 
   // Initialization.
 
-  NumberRecognizer &init(unsigned opts = DefaultOptions) {
+  NumberRecognizer &init(unsigned opts = InitialOptions) {
     NumberRecognizerState::init(opts);
     start = nullptr;
     return *this;
@@ -389,7 +1489,18 @@ public:
   NumberRecognizer &init(const CharT *str, unsigned len, unsigned opts) {
     NumberRecognizerState::init(opts);
     start = str;
-    length = TraitT::length(str);
+    length = len;
+    return *this;
+  }
+
+  /// \brief Restores results of recognition of the text, which were kept in
+  /// compact form, so that the number may be converted without recognizing
+  /// it again.
+  ///
+  NumberRecognizer &init(const CharT *str, const CompactRecognizerState &state,
+                         unsigned opts = InitialOptions) {
+    state.restore(*this, static_cast<unsigned char>(opts));
+    start = str;
     return *this;
   }
 
@@ -397,11 +1508,27 @@ public:
                          unsigned opts, unsigned b) {
     NumberRecognizerState::init(opts);
     start = str;
-    length = TraitT::length(str);
+    length = len;
     set_base(b);
     return *this;
   }
 
+  // Recognizer options. If they are fixed, the methods return compile time
+  // constants.
+
+  bool is_allowed_0x() const { return is_allowed(Prefix0x); }
+  bool is_allowed_0o() const { return is_allowed(Prefix0o); }
+  bool is_allowed_0q() const { return is_allowed(Prefix0q); }
+  bool is_allowed_0b() const { return is_allowed(Prefix0b); }
+  bool is_allowed_0() const { return is_allowed(Prefix0); }
+  bool is_allowed_float() const { return is_allowed(Floating); }
+  bool is_allowed_hex_float() const { return is_allowed(HexFloating); }
+
+  bool is_float() const {
+    return (is_allowed_float() || is_allowed_hex_float()) &&
+           NumberRecognizerState::is_float();
+  }
+
   // Get pointers to different parts of recognized number.
 
   const CharT *begin() const { return start; }
@@ -513,10 +1640,11 @@ public:
 
     const CharT *end = start + length;
     const CharT *cursor = start;
+    if (FixedBase)
+      base = FixedBase;
 
     // Skip leading spaces.
-    while (cursor != end && std::isspace(TraitT::to_int_type(*cursor)))
-      ++cursor;
+    cursor = internal::scan_spaces(cursor, end);
     leading_ws = cursor - start;
     int_start = frac_start = exp_start = rest_start = leading_ws;
     if (cursor == end) {
@@ -542,25 +1670,26 @@ public:
 
     // Recognize prefix.
     if (*cursor == '0') {
-      if (base == 0) {
+      if (current_base() == 0) {
         // Possible radix indicator
         if (end - cursor > 2) {
           if (cursor[1] == 'x' || cursor[1] == 'X') {
-            if (is_allowed_0x() && std::isxdigit(TraitT::to_int_type(cursor[2]))) {
+            if (is_allowed_0x() &&
+                (internal::is_hex_char(cursor[2]) ||
+                 (is_allowed_hex_float() && cursor[2] == CharT('.') &&
+                  end - cursor > 3 && internal::is_hex_char(cursor[3])))) {
               base = 16;
               cursor += 2;
               has_prefix = true;
             }
           } else if (cursor[1] == 'o' || cursor[1] == 'O') {
-            if (is_allowed_0o() && std::isdigit(TraitT::to_int_type(cursor[2])) &&
-                cursor[2] != '8' && cursor[2] != '9') {
+            if (is_allowed_0o() && internal::digit_value(cursor[2]) < 8) {
               base = 8;
               cursor += 2;
               has_prefix = true;
             }
           } else if (cursor[1] == 'q' || cursor[1] == 'Q') {
-            if (is_allowed_0q() && std::isdigit(TraitT::to_int_type(cursor[2])) &&
-                cursor[2] != '8' && cursor[2] != '9') {
+            if (is_allowed_0q() && internal::digit_value(cursor[2]) < 8) {
               base = 8;
               cursor += 2;
               has_prefix = true;
@@ -573,25 +1702,25 @@ public:
             }
           }
         }
-        if (base == 0 && is_allowed_0())
+        if (current_base() == 0 && is_allowed_0())
           base = 8;
       }
 
       // Skip leading zeros of integer part.
       while (*cursor == '0' && cursor + 1 != end &&
-             std::isdigit(TraitT::to_int_type(cursor[1]))) ++cursor;
+             internal::is_decimal_char(cursor[1])) ++cursor;
     }
-    if (base == 0)
+    if (current_base() == 0)
       base = 10;
 
     // Collect digits of integer part.
     int_start = frac_start = exp_start = rest_start = (cursor - start);
     const CharT *int_begin = cursor;
-    while (cursor != end) {
-      typename TraitT::int_type ch = TraitT::to_int_type(*cursor);
-      if (!check_digit(ch))
-        break;
-      ++cursor;
+    if (current_base() == 10) {
+      cursor = internal::scan_digits(cursor, end);
+    } else {
+      while (cursor != end && check_digit(*cursor))
+        ++cursor;
     }
     if (cursor != int_begin) {
       int_length = cursor - int_begin;
@@ -603,11 +1732,19 @@ public:
       return *this;
     }
 
-    // If base is no 10, no other parts may present.
-    if (base != 10 || !is_allowed_float()) {
-      if (int_length)
-        result = Partial;
-      else {
+    // If base is no 10, no other parts may present, only trailing spaces.
+    // The exception is hexadecimal float notation, in which the number has
+    // hexadecimal fraction and binary exponent.
+    bool hex_float = current_base() == 16 && has_prefix &&
+                     is_allowed_hex_float();
+    if (current_base() == 10 ? !is_allowed_float() : !hex_float) {
+      if (int_length) {
+        const CharT *ws_begin = cursor;
+        cursor = internal::scan_spaces(cursor, end);
+        trailing_ws = cursor - ws_begin;
+        rest_start = cursor - start;
+        result = (cursor == end) ? Success : Partial;
+      } else {
         result = Failure;
         status = NaN;
       }
@@ -624,11 +1761,11 @@ public:
     // Collect fractional part.
     if (has_dot) {
       const CharT *frac_begin = cursor;
-      while (cursor != end) {
-        typename TraitT::int_type ch = TraitT::to_int_type(*cursor);
-        if (!std::isdigit(ch))
-          break;
-        ++cursor;
+      if (hex_float) {
+        while (cursor != end && check_digit(*cursor))
+          ++cursor;
+      } else {
+        cursor = internal::scan_digits(cursor, end);
       }
 
       // Skip trailing zeros.
@@ -655,22 +1792,19 @@ public:
       return *this;
     }
 
-    // Exponential part.
-    if (end - cursor < 2) {
-      result = Partial;
-      return *this;
-    }
-    if (*cursor == CharT('e') || *cursor == CharT('E')) {
+    // Exponential part. In hexadecimal float notation it starts with 'p', as
+    // 'e' is a digit, but the exponent is decimal in both cases.
+    if (hex_float ? internal::is_binary_exponent_char(*cursor)
+                  : internal::is_exponent_char(*cursor)) {
+      if (end - cursor < 2) {
+        result = Partial;
+        return *this;
+      }
       // Optional sign.
-      typename TraitT::int_type ch = TraitT::to_int_type(cursor[1]);
-      if ((ch == CharT('+') || ch == CharT('-')) && (end - cursor >= 2)) {
-        if (std::isdigit(TraitT::to_int_type(cursor[2]))) {
-          if (ch == CharT('+'))
-            exp_sign = Positive;
-          else if (ch == CharT('-'))
-            exp_sign = Negative;
-          else
-            exp_sign = NoSign;
+      CharT ch = cursor[1];
+      if (internal::is_sign_char(ch)) {
+        if (end - cursor > 2 && internal::is_decimal_char(cursor[2])) {
+          exp_sign = (ch == CharT('-')) ? Negative : Positive;
           cursor += 2;
         } else {
           result = Partial;
@@ -678,7 +1812,7 @@ public:
         }
       } else {
         // At least one digit must present.
-        if (!std::isdigit(TraitT::to_int_type(cursor[1]))) {
+        if (!internal::is_decimal_char(cursor[1])) {
           result = Partial;
           return *this;
         }
@@ -697,25 +1831,20 @@ public:
         result = Success;
         return *this;
       }
-      if (!std::isdigit(TraitT::to_int_type(*cursor))) {
+      if (!internal::is_decimal_char(*cursor)) {
         --cursor;
         --exp_leading_zeros;
       }
       exp_start = cursor - start;
       // Collect digits of exponent.
-      while (cursor != end) {
-        if (!std::isdigit(TraitT::to_int_type(*cursor)))
-          break;
-        ++cursor;
-      }
+      cursor = internal::scan_digits(cursor, end);
       exp_length = cursor - start - exp_start;
     }
 
     // Skip trailing spaces.
-    while (cursor != end && std::isspace(TraitT::to_int_type(*cursor))) {
-      ++trailing_ws;
-      ++cursor;
-    }
+    const CharT *ws_begin = cursor;
+    cursor = internal::scan_spaces(cursor, end);
+    trailing_ws = cursor - ws_begin;
     rest_start = cursor - start;
 
     // Recognition is finished.
@@ -739,124 +1868,89 @@ public:
       return static_cast<Status>(status = NaN);
     }
 
-    // If the recognized number contains only integer part, convert
-    // corresponding sequence of digits. It works if NumType is a float type
-    // as well.
-    if (!is_float()) {
-      Status st = convert_int(value, get_int(), get_base());
-      set_sign(value, is_negative(), st);
-      return st;
-    }
-
-    // We have recognized a floating number. Check exponent first, it must not
-    // be too large.
-    if (get_exp_length() > 3) {
-      // Strictly speaking, it is not true. Adding digits to integer of
-      // fractional part, it is possible to compensate exponent. It is however
-      // unlikely that a user would write several dozens of digits.
-      if (is_exp_negative()) {
-        value = 0;
-        return static_cast<Status>(status = DoubleUnderflow);
-      } else {
-        if (is_negative())
-          value = extra::number_property<NumType>::lowest();
-        else
-          value = std::numeric_limits<NumType>::max();
-        return static_cast<Status>(status = DoubleOverflow);
-      }
-    }
+    // Get exponent value.
+    int expval = exp_length ? internal::read_exponent(get_exp()) : 0;
 
-    int expval;
-    if (exp_length) {
-      Status st = convert_int(expval, get_exp());
-      assert(st == OK); (void)st;
-    } else {
-      expval = 0;
-    }
+    return convert_parts(value, get_int(), get_frac(), expval, 0, is_float(),
+                         current_base());
+  }
 
-    // If NumType is an integer type, make conversion to integer.
-    if (std::numeric_limits<NumType>::is_integer) {
-      // Exponent can move digits from fractional part to integer and back.
-      // TODO: make conversion to integer here, without call to strtod.
-      if (is_exp_negative()) {
-        if (get_int_length() < (unsigned)expval) {
-          value = 0;
-          return static_cast<Status>(status = DoubleToInt);
-        }
-        status = convert_int(value, begin_int(), get_int_length());
-        return static_cast<Status>(status);
-      }
-    }
+  template<typename NumType>
+  NumType to() {
+    NumType value;
+    read(value);
+    return value;
+  }
 
-    // Textual representation of a float value is converted to float data type.
+  /// \brief Converts recognized number to fixed point value, which is an
+  /// integer that counts units of 10^-Scale.
+  ///
+  /// \tparam IntType Integer type of the result.
+  /// \tparam Scale   Number of decimal digits after the point kept in the
+  ///                 result, for instance text "12.345" is read as 1234 if
+  ///                 Scale is 2.
+  ///
+  /// \param value Receives the result.
+  /// \param mode  Rounding of the digits beyond the scale.
+  ///
+  /// \returns OK if the value is exact, DoubleToInt if nonzero digits are
+  /// rounded off, IntOverflow or IntOverflowNegative if the value does not fit
+  /// the type, NaN if the text is not a number or is written in hexadecimal
+  /// float notation.
+  ///
+  /// The value is built from the digits of the text, no floating point
+  /// calculations are made, so it is exact for any number of digits.
+  ///
+  template<typename IntType, unsigned Scale>
+  Status read_fixed(IntType &value, RoundingMode mode = RoundHalfEven) {
+    if (!recognized())
+      recognize();
 
-    // Filter out some cases based on exponent value.
-    if (is_exp_negative())
-      expval = -expval;
-    if (!std::numeric_limits<NumType>::is_integer) {
-      if (expval > std::numeric_limits<NumType>::max_exponent10) {
-        value = std::numeric_limits<NumType>::max();
-        return static_cast<Status>(status = DoubleOverflow);
-      } else if (expval < std::numeric_limits<NumType>::min_exponent10) {
-        if (!std::numeric_limits<NumType>::has_denorm)
-          return static_cast<Status>(status = DoubleUnderflow);
-        if (expval < extra::number_property<NumType>::denorm_min_exponent10) {
-          value = 0;
-          return static_cast<Status>(status = DoubleUnderflow);
-        }
-      }
+    if (get_result() == Failure) {
+      value = 0;
+      return static_cast<Status>(status = NaN);
     }
 
-    // Convert text to number.
-    double dvalue = strto<double>(begin_number(), get_number_length());
-    auto res = convert_to<NumType>(dvalue);
-    value = res.value();
-    status = res.status();
-    if (res.ok())
-      status = Status::OK;
-    return static_cast<Status>(status);
+    int expval = exp_length ? internal::read_exponent(get_exp()) : 0;
+    return convert_fixed(value, get_int(), get_frac(), expval, Scale,
+                         current_base(), mode);
   }
 
-  template<typename NumType>
-  NumType to() {
-    NumType value;
-    read(value);
+  template<typename IntType, unsigned Scale>
+  IntType to_fixed(RoundingMode mode = RoundHalfEven) {
+    IntType value;
+    read_fixed<IntType, Scale>(value, mode);
     return value;
   }
 
   private:
 
-  bool check_digit(typename TraitT::int_type ch) {
-    if (base == 2) {
-      if (ch == CharT('0') || ch == CharT('1'))
-        return true;
-    } else if (base == 8) {
-      if (ch >= CharT('0') && ch <= CharT('7'))
-        return true;
-    } else if (base == 10) {
-      if (std::isdigit(ch))
-        return true;
-    } else if (base == 16) {
-      if (std::isxdigit(ch))
-        return true;
-    } else {
-      assert(base == 0);
-      if (std::isdigit(ch))
-        return true;
-    }
-    return false;
+  bool check_digit(CharT ch) {
+    unsigned b = current_base();
+    assert(b == 2 || b == 8 || b == 10 || b == 16);
+    return internal::digit_value(ch) < b;
   }
 
-  template<typename NumType>
-  void set_sign(NumType &value, bool is_neg, Status &st) {
-    internal::SetSign<
-      NumType,
-      std::numeric_limits<NumType>::is_integer,
-      std::numeric_limits<NumType>::is_signed
-    >::set(value, is_neg, st);
-    status = st;
+  bool is_allowed(Option opt) const {
+    if (FixedOptions != DynamicOptions)
+      return (FixedOptions & opt) != 0;
+    return (options & opt) != 0;
+  }
+
+  unsigned current_base() const {
+    return FixedBase ? FixedBase : base;
   }
 };
 
+
+/// \brief Recognizer which options and base are fixed at compile time.
+///
+/// For instance, StaticNumberRecognizer<0, 10> recognizes decimal integers
+/// only.
+///
+template<unsigned Options, unsigned char Base = 0, typename CharT = char>
+using StaticNumberRecognizer =
+  NumberRecognizer<CharT, std::char_traits<CharT>, Options, Base>;
+
 }
 #endif
@@ -0,0 +1,195 @@
+//===--- parallel_parser.h --------------------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Parallel conversion of large delimited buffers.
+///
+/// The buffer is split into chunks on delimiter boundaries. Threads take
+/// chunks one by one from shared counter, so that a thread that finished its
+/// chunk early proceeds with the next one. Conversion does not use any global
+/// state, in particular it does not use C library functions that set errno.
+///
+//===----------------------------------------------------------------------===//
+#ifndef CONVERSION_PARALLEL_PARSER_H_
+#define CONVERSION_PARALLEL_PARSER_H_
+
+//------ Dependencies ----------------------------------------------------------
+#include "column_parser.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <stddef.h>
+//------------------------------------------------------------------------------
+
+
+namespace conversion {
+
+/// \brief Result of conversion of a chunk of delimited buffer.
+struct ChunkResult {
+  size_t begin;         ///< Offset of the first character of the chunk
+  size_t end;           ///< Offset past the last character of the chunk
+  size_t first_field;   ///< Index of the first field of the chunk in output
+  size_t field_count;   ///< Number of fields of the chunk stored in output
+  size_t error_count;   ///< Number of fields converted with error
+  size_t first_error;   ///< Index of the first field with error in output,
+                        ///< or first_field + field_count if there is none
+};
+
+
+/// Default size of a chunk in characters.
+const size_t DefaultChunkSize = 1 << 20;
+
+
+namespace internal {
+
+/// \brief Calls func(i) for i in [0, n) using the specified number of
+/// threads, the calling thread included.
+///
+template<typename Func>
+void run_parallel(unsigned threads, size_t n, Func func) {
+  std::atomic<size_t> next(0);
+  auto worker = [&]() {
+    for (size_t i = next++; i < n; i = next++)
+      func(i);
+  };
+  size_t workers = std::min<size_t>(threads, n);
+  std::vector<std::thread> pool;
+  for (size_t i = 1; i < workers; ++i)
+    pool.emplace_back(worker);
+  worker();
+  for (auto &thread : pool)
+    thread.join();
+}
+
+
+/// \brief Splits the buffer into chunks, each chunk except the last one ends
+/// right after a delimiter.
+///
+template<typename CharT>
+std::vector<ChunkResult> split_chunks(const CharT *buf, size_t len,
+                                      CharT delim, size_t chunk_size) {
+  typedef std::char_traits<CharT> TraitT;
+  std::vector<ChunkResult> chunks;
+  size_t pos = 0;
+  while (pos < len) {
+    size_t end = len;
+    if (len - pos > chunk_size) {
+      const CharT *found = TraitT::find(buf + pos + chunk_size,
+                                        len - pos - chunk_size, delim);
+      if (found)
+        end = found - buf + 1;
+    }
+    ChunkResult chunk = { pos, end, 0, 0, 0, 0 };
+    chunks.push_back(chunk);
+    pos = end;
+  }
+  return chunks;
+}
+
+}
+
+
+/// \brief Converts fields of a buffer separated by delimiter into array of
+/// numbers using several threads.
+///
+/// \param buf        Buffer with texts of numbers.
+/// \param len        Buffer length.
+/// \param delim      Character that separates fields.
+/// \param out        Output array, receives converted values in the order of
+///                   fields in the buffer.
+/// \param st         Output array, receives status of each conversion. May be
+///                   null.
+/// \param max_count  Size of the output arrays, fields beyond it are ignored.
+/// \param threads    Number of threads, 0 means the number of processors.
+/// \param opts       Recognizer options.
+/// \param chunk_size Approximate chunk size in characters.
+///
+/// Fields are determined and converted as in parse_delimited, so the results
+/// are identical to those obtained by single call to it.
+///
+/// \returns Results of conversion of each chunk, in the order of chunks.
+///
+template<typename NumType, typename CharT>
+std::vector<ChunkResult> parse_delimited_parallel(
+    const CharT *buf, size_t len, CharT delim, NumType *out, Status *st,
+    size_t max_count, unsigned threads = 0, unsigned opts = DefaultOptions,
+    size_t chunk_size = DefaultChunkSize) {
+  if (threads == 0)
+    threads = std::max(1U, std::thread::hardware_concurrency());
+  if (chunk_size == 0)
+    chunk_size = 1;
+  std::vector<ChunkResult> chunks =
+    internal::split_chunks(buf, len, delim, chunk_size);
+
+  // Count fields in each chunk to know where its results are stored.
+  internal::run_parallel(threads, chunks.size(), [&](size_t i) {
+    ChunkResult &chunk = chunks[i];
+    chunk.field_count = count_fields(buf + chunk.begin,
+                                     chunk.end - chunk.begin, delim);
+  });
+  size_t first_field = 0;
+  for (ChunkResult &chunk : chunks) {
+    chunk.first_field = std::min(first_field, max_count);
+    first_field += chunk.field_count;
+    chunk.field_count = std::min(first_field, max_count) - chunk.first_field;
+  }
+
+  // Convert chunks. If the caller does not need statuses, they are stored in
+  // temporary array to count errors.
+  internal::run_parallel(threads, chunks.size(), [&](size_t i) {
+    ChunkResult &chunk = chunks[i];
+    chunk.first_error = chunk.first_field + chunk.field_count;
+    if (chunk.field_count == 0)
+      return;
+    std::vector<Status> local;
+    Status *statuses = st ? st + chunk.first_field : nullptr;
+    if (!statuses) {
+      local.resize(chunk.field_count);
+      statuses = local.data();
+    }
+    size_t converted = parse_delimited(buf + chunk.begin,
+                                       chunk.end - chunk.begin, delim,
+                                       out + chunk.first_field, statuses,
+                                       chunk.field_count, opts);
+    assert(converted == chunk.field_count);
+    (void)converted;
+    for (size_t f = 0; f < chunk.field_count; ++f) {
+      if (statuses[f] >= OkCodes) {
+        if (chunk.error_count == 0)
+          chunk.first_error = chunk.first_field + f;
+        ++chunk.error_count;
+      }
+    }
+  });
+  return chunks;
+}
+
+}
+#endif
@@ -0,0 +1,521 @@
+//===--- stream_recognizer.h ------------------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Recognition of numbers that arrive in pieces.
+///
+/// StreamNumberRecognizer gets text by arbitrary portions, for instance as it
+/// is read from a socket, and recognizes the number without gluing the
+/// portions together. Between calls it keeps only its state, which has fixed
+/// size.
+///
+//===----------------------------------------------------------------------===//
+#ifndef CONVERSION_STREAM_RECOGNIZER_H_
+#define CONVERSION_STREAM_RECOGNIZER_H_
+
+//------ Dependencies ----------------------------------------------------------
+#include "number_recognizer.h"
+#include <algorithm>
+//------------------------------------------------------------------------------
+
+
+namespace conversion {
+
+/// \brief Recognizer that gets text by portions.
+///
+/// \tparam CharT Character type.
+///
+/// Text is passed by calls to feed(), end of text is signaled by finish().
+/// Offsets of number parts and the conversion results are the same as
+/// NumberRecognizer produces for the whole text, offsets are counted from the
+/// first character passed to feed().
+///
+/// To resolve some constructs the recognizer looks up to two characters
+/// ahead, so the number may end before the last character consumed. The end
+/// of the number is given by get_rest_start().
+///
+/// Digits of the number are kept in internal buffer, which is large enough to
+/// obtain correctly rounded result. Digits beyond its capacity affect only
+/// the order of magnitude and rounding of the result.
+///
+/// Option HexFloating is not supported, numbers with prefix 0x are always
+/// recognized as integers.
+///
+template<typename CharT = char>
+class StreamNumberRecognizer : public NumberRecognizerState {
+public:
+  /// Capacity of digit buffer, enough for correct rounding of any double.
+  static const unsigned MaxDigits = 800;
+  static_assert(MaxDigits > internal::BinaryFormat<double>::max_digits,
+                "digit buffer is too small");
+
+  StreamNumberRecognizer(unsigned opts = DefaultOptions) { reset(opts); }
+
+  /// \brief Prepares the recognizer for new number, options are kept.
+  StreamNumberRecognizer &reset() { return reset(get_options()); }
+
+  /// \brief Prepares the recognizer for new number with new options.
+  StreamNumberRecognizer &reset(unsigned opts) {
+    NumberRecognizerState::init(opts);
+    stage = LeadingSpace;
+    mark = 0;
+    marker = 0;
+    int_stored = frac_stored = frac_significant = 0;
+    int_dropped = frac_skipped = 0;
+    frac_total = frac_last_nonzero = 0;
+    nonzero_seen = sticky = false;
+    exp_value = 0;
+    return *this;
+  }
+
+  /// \brief Passes next portion of text to the recognizer.
+  ///
+  /// \returns True if the number may continue in the next portion, false if
+  ///          recognition is finished.
+  ///
+  bool feed(const CharT *str, unsigned len) {
+    for (unsigned i = 0; i < len && stage != Done; ) {
+      if (step(str[i])) {
+        ++i;
+        ++length;
+      }
+    }
+    return stage != Done;
+  }
+
+  /// \brief Signals that there is no more text.
+  ///
+  void finish() {
+    switch (stage) {
+    case LeadingSpace:
+      leading_ws = length;
+      start_int(length);
+      return fail();
+    case NumberStart:
+      return fail();
+    case PrefixZero:
+      if (is_allowed_0())
+        base = 8;
+      // fall through
+    case LeadingZero:
+      resolve_base();
+      start_int(mark);
+      append_int_digit(CharT('0'));
+      // fall through
+    case IntDigits:
+      if (int_length == 0)
+        return fail();
+      end_int(length);
+      return done(Success);
+    case PrefixLetter:
+      return no_prefix();
+    case FracDigits:
+      if (!end_frac())
+        return;
+      exp_start = rest_start = length;
+      return done(Success);
+    case ExpMarker:
+    case ExpSign:
+      return done(Partial);
+    case ExpZeros:
+      single_zero_exponent();
+      rest_start = length;
+      return done(Success);
+    case ExpCheck:
+    case ExpDigits:
+    case TrailingSpace:
+      rest_start = length;
+      return done(Success);
+    case Done:
+      return;
+    }
+  }
+
+  /// \brief Returns the number of characters consumed so far.
+  unsigned get_position() const { return length; }
+
+  /// \brief Converts the recognized number.
+  ///
+  /// If finish() was not called yet, the text is considered complete.
+  ///
+  template<typename NumType>
+  Status read(NumType &value) {
+    if (!recognized())
+      finish();
+    if (get_result() == Failure) {
+      value = 0;
+      return static_cast<Status>(status = NaN);
+    }
+
+    // Digits that did not fit the buffer are represented by exponent and by
+    // nonzero digit appended to the stored ones if they were not all zeros.
+    unsigned int_len = int_stored;
+    unsigned frac_len = frac_significant;
+    long long scale = int_dropped;
+    scale -= frac_skipped;
+    if (sticky) {
+      digits[int_stored + frac_stored] = '1';
+      if (int_dropped) {
+        ++int_len;
+        --scale;
+      } else {
+        frac_len = frac_stored + 1;
+      }
+    }
+    if (scale > internal::MaxExponent)
+      scale = internal::MaxExponent;
+    if (scale < -internal::MaxExponent)
+      scale = -internal::MaxExponent;
+
+    return convert_parts(value,
+                         std::tuple<const char *, unsigned>(digits, int_len),
+                         std::tuple<const char *, unsigned>(
+                           digits + int_stored, frac_len),
+                         exp_length ? exp_value : 0, static_cast<int>(scale),
+                         is_float(), base);
+  }
+
+  template<typename NumType>
+  NumType to() {
+    NumType value;
+    read(value);
+    return value;
+  }
+
+private:
+
+  /// Recognition stages.
+  enum Stage : unsigned char {
+    LeadingSpace,   ///< Skipping leading spaces
+    NumberStart,    ///< Sign is processed
+    PrefixZero,     ///< '0' that may start prefix is seen
+    PrefixLetter,   ///< '0' and prefix letter are seen
+    LeadingZero,    ///< '0' that may be a leading zero is seen
+    IntDigits,      ///< Collecting digits of integer part
+    FracDigits,     ///< Collecting digits of fractional part
+    ExpCheck,       ///< Mantissa is finished, exponent may follow
+    ExpMarker,      ///< Exponent marker is seen
+    ExpSign,        ///< Exponent marker and sign are seen
+    ExpZeros,       ///< Skipping leading zeros of exponent
+    ExpDigits,      ///< Collecting digits of exponent
+    TrailingSpace,  ///< Skipping trailing spaces
+    Done            ///< Recognition is finished
+  };
+
+  Stage stage;
+  unsigned mark;              ///< Position of a character which role is not
+                              ///< determined yet
+  char marker;                ///< Prefix letter
+  unsigned int_stored;        ///< Digits of integer part in buffer
+  unsigned frac_stored;       ///< Digits of fractional part in buffer
+  unsigned frac_significant;  ///< Same without trailing zeros
+  unsigned int_dropped;       ///< Digits of integer part beyond buffer
+  unsigned frac_skipped;      ///< Leading zeros of fractional part, that are
+                              ///< not stored
+  unsigned frac_total;        ///< Digits of fractional part seen so far
+  unsigned frac_last_nonzero; ///< Number of fractional digits up to the last
+                              ///< nonzero one
+  bool nonzero_seen;          ///< Nonzero digit of mantissa is seen
+  bool sticky;                ///< Nonzero digit is beyond buffer
+  int exp_value;              ///< Absolute value of exponent
+  char digits[MaxDigits + 1];
+
+  void done(Result res) {
+    result = res;
+    stage = Done;
+  }
+
+  void fail() {
+    status = NaN;
+    done(Failure);
+  }
+
+  void resolve_base() {
+    if (base == 0)
+      base = 10;
+  }
+
+  void start_int(unsigned pos) {
+    int_start = frac_start = exp_start = rest_start = pos;
+  }
+
+  void end_int(unsigned pos) {
+    if (int_length)
+      frac_start = exp_start = rest_start = pos;
+  }
+
+  void append_int_digit(CharT ch) {
+    ++int_length;
+    if (ch != CharT('0'))
+      nonzero_seen = true;
+    if (int_stored < MaxDigits) {
+      digits[int_stored++] = static_cast<char>(ch);
+    } else {
+      ++int_dropped;
+      if (ch != CharT('0'))
+        sticky = true;
+    }
+  }
+
+  void append_frac_digit(CharT ch) {
+    ++frac_total;
+    if (ch != CharT('0'))
+      frac_last_nonzero = frac_total;
+    if (!nonzero_seen && ch == CharT('0')) {
+      ++frac_skipped;
+      return;
+    }
+    nonzero_seen = true;
+    if (int_stored + frac_stored < MaxDigits) {
+      digits[int_stored + frac_stored++] = static_cast<char>(ch);
+      if (ch != CharT('0'))
+        frac_significant = frac_stored;
+    } else if (ch != CharT('0')) {
+      sticky = true;
+    }
+  }
+
+  // Computes length of fractional part as NumberRecognizer does.
+  bool end_frac() {
+    if (frac_last_nonzero == 0 && int_length == 0 && frac_total != 0)
+      frac_length = 1;
+    else
+      frac_length = frac_last_nonzero;
+    if (int_length == 0 && frac_length == 0) {
+      rest_start = 0;
+      fail();
+      return false;
+    }
+    return true;
+  }
+
+  // '0' followed by prefix letter is not a prefix. The number is '0' and the
+  // letter cannot continue it.
+  void no_prefix() {
+    if (is_allowed_0())
+      base = 8;
+    resolve_base();
+    start_int(mark);
+    append_int_digit(CharT('0'));
+    end_int(mark + 1);
+    done(Partial);
+  }
+
+  // Exponent consists of zeros only, the last of them is the exponent.
+  void single_zero_exponent() {
+    exp_start = mark;
+    --exp_leading_zeros;
+    exp_length = 1;
+    exp_value = 0;
+  }
+
+  // Processes a character. Returns true if the character is consumed, false
+  // if it must be processed again in new stage.
+  bool step(CharT ch) {
+    switch (stage) {
+    case LeadingSpace:
+      if (internal::is_space_char(ch))
+        return true;
+      leading_ws = length;
+      start_int(length);
+      stage = NumberStart;
+      if (ch == CharT('+') || ch == CharT('-')) {
+        sign = (ch == CharT('+')) ? Positive : Negative;
+        return true;
+      }
+      sign = NoSign;
+      return false;
+
+    case NumberStart:
+      if (ch == CharT('0')) {
+        mark = length;
+        stage = (base == 0) ? PrefixZero : LeadingZero;
+        return true;
+      }
+      resolve_base();
+      start_int(length);
+      stage = IntDigits;
+      return false;
+
+    case PrefixZero:
+      if (((ch == CharT('x') || ch == CharT('X')) && is_allowed_0x()) ||
+          ((ch == CharT('o') || ch == CharT('O')) && is_allowed_0o()) ||
+          ((ch == CharT('q') || ch == CharT('Q')) && is_allowed_0q()) ||
+          ((ch == CharT('b') || ch == CharT('B')) && is_allowed_0b())) {
+        marker = static_cast<char>(ch | 0x20);
+        stage = PrefixLetter;
+        return true;
+      }
+      if (is_allowed_0())
+        base = 8;
+      stage = LeadingZero;
+      return false;
+
+    case PrefixLetter: {
+      unsigned char prefix_base = marker == 'x' ? 16 : marker == 'b' ? 2 : 8;
+      if (internal::digit_value(ch) >= prefix_base) {
+        no_prefix();
+        return false;
+      }
+      base = prefix_base;
+      has_prefix = true;
+      stage = NumberStart;
+      return false;
+    }
+
+    case LeadingZero:
+      if (internal::is_decimal_char(ch)) {
+        if (ch == CharT('0')) {
+          mark = length;
+          return true;
+        }
+        resolve_base();
+        start_int(length);
+      } else {
+        resolve_base();
+        start_int(mark);
+        append_int_digit(CharT('0'));
+      }
+      stage = IntDigits;
+      return false;
+
+    case IntDigits:
+      if (internal::digit_value(ch) < base) {
+        append_int_digit(ch);
+        return true;
+      }
+      end_int(length);
+      if (base != 10 || !is_allowed_float()) {
+        if (int_length == 0) {
+          fail();
+          return false;
+        }
+        stage = TrailingSpace;
+        return false;
+      }
+      if (ch == CharT('.')) {
+        has_dot = true;
+        frac_start = exp_start = rest_start = length + 1;
+        stage = FracDigits;
+        return true;
+      }
+      if (int_length == 0) {
+        rest_start = 0;
+        fail();
+        return false;
+      }
+      exp_start = rest_start = length;
+      stage = ExpCheck;
+      return false;
+
+    case FracDigits:
+      if (internal::is_decimal_char(ch)) {
+        append_frac_digit(ch);
+        return true;
+      }
+      if (!end_frac())
+        return false;
+      exp_start = rest_start = length;
+      stage = ExpCheck;
+      return false;
+
+    case ExpCheck:
+      if (internal::is_exponent_char(ch)) {
+        stage = ExpMarker;
+        return true;
+      }
+      stage = TrailingSpace;
+      return false;
+
+    case ExpMarker:
+      if (internal::is_sign_char(ch)) {
+        marker = static_cast<char>(ch);
+        stage = ExpSign;
+        return true;
+      }
+      if (!internal::is_decimal_char(ch)) {
+        done(Partial);
+        return false;
+      }
+      stage = ExpZeros;
+      return false;
+
+    case ExpSign:
+      if (!internal::is_decimal_char(ch)) {
+        done(Partial);
+        return false;
+      }
+      exp_sign = (marker == '-') ? Negative : Positive;
+      stage = ExpZeros;
+      return false;
+
+    case ExpZeros:
+      if (ch == CharT('0')) {
+        ++exp_leading_zeros;
+        mark = length;
+        return true;
+      }
+      if (internal::is_decimal_char(ch)) {
+        exp_start = length;
+        stage = ExpDigits;
+        return false;
+      }
+      single_zero_exponent();
+      stage = TrailingSpace;
+      return false;
+
+    case ExpDigits:
+      if (internal::is_decimal_char(ch)) {
+        ++exp_length;
+        if (exp_value < internal::MaxExponent)
+          exp_value = std::min(exp_value * 10 + internal::digit_value(ch),
+                               internal::MaxExponent);
+        return true;
+      }
+      stage = TrailingSpace;
+      return false;
+
+    case TrailingSpace:
+      if (internal::is_space_char(ch)) {
+        ++trailing_ws;
+        return true;
+      }
+      rest_start = length;
+      done(Partial);
+      return false;
+
+    case Done:
+      break;
+    }
+    return false;
+  }
+};
+
+}
+#endif
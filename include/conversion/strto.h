@@ -41,6 +41,7 @@
 #include <assert.h>
 #include <math.h>
 #include <memory.h>
+#include <errno.h>
 //------------------------------------------------------------------------------
 
 
@@ -0,0 +1,238 @@
+//===--- char_scanner.cpp ---------------------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Vectorized implementations of character scanner.
+///
+//===----------------------------------------------------------------------===//
+
+//------ Dependencies ----------------------------------------------------------
+#include "conversion/arithmetic.h"
+#include "conversion/char_scanner.h"
+#include "conversion/cpu_dispatch.h"
+#include <stdint.h>
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CONVERSION_X86_SCANNER 1
+#include <immintrin.h>
+#endif
+//------------------------------------------------------------------------------
+
+namespace conversion {
+namespace internal {
+
+namespace {
+
+typedef const char *(*ScanFunction)(const char *, const char *);
+typedef bool (*HexFunction)(const char *, uint64_t &);
+
+
+const char *scalar_spaces(const char *cursor, const char *end) {
+  return scan_spaces<char>(cursor, end);
+}
+
+const char *scalar_digits(const char *cursor, const char *end) {
+  return scan_digits<char>(cursor, end);
+}
+
+bool scalar_hex(const char *str, uint64_t &value) {
+  uint64_t high = load_eight_bytes(str);
+  uint64_t low = load_eight_bytes(str + 8);
+  if (!is_eight_hex_digits(high) || !is_eight_hex_digits(low))
+    return false;
+  value = (uint64_t(parse_eight_hex_digits(high)) << 32) |
+          parse_eight_hex_digits(low);
+  return true;
+}
+
+
+#ifdef CONVERSION_X86_SCANNER
+
+// Bytes are compared as signed values. Bytes 0x80..0xFF are negative, so they
+// never fall into ranges of ASCII characters.
+
+__attribute__((target("sse2")))
+inline __m128i in_range_sse2(__m128i chars, char low, char high) {
+  return _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8(low - 1)),
+                       _mm_cmplt_epi8(chars, _mm_set1_epi8(high + 1)));
+}
+
+__attribute__((target("sse2")))
+const char *sse2_spaces(const char *cursor, const char *end) {
+  for (; end - cursor >= 16; cursor += 16) {
+    __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(cursor));
+    __m128i match = _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8(' ')),
+                                 in_range_sse2(chars, '\t', '\r'));
+    unsigned mismatch = ~static_cast<unsigned>(_mm_movemask_epi8(match)) &
+                        0xFFFFU;
+    if (mismatch)
+      return cursor + __builtin_ctz(mismatch);
+  }
+  return scalar_spaces(cursor, end);
+}
+
+__attribute__((target("sse2")))
+const char *sse2_digits(const char *cursor, const char *end) {
+  for (; end - cursor >= 16; cursor += 16) {
+    __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(cursor));
+    __m128i match = in_range_sse2(chars, '0', '9');
+    unsigned mismatch = ~static_cast<unsigned>(_mm_movemask_epi8(match)) &
+                        0xFFFFU;
+    if (mismatch)
+      return cursor + __builtin_ctz(mismatch);
+  }
+  return scalar_digits(cursor, end);
+}
+
+// Digit values are obtained as in the scalar code: the lower nibble, plus 9
+// for letters. Then bytes of adjacent digits are merged into 16-bit words,
+// words are packed into bytes, and the bytes are reversed, so that the first
+// digit becomes the most significant.
+__attribute__((target("sse2")))
+bool sse2_hex(const char *str, uint64_t &value) {
+  __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(str));
+  __m128i lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+  __m128i alpha = in_range_sse2(lower, 'a', 'f');
+  __m128i valid = _mm_or_si128(in_range_sse2(chars, '0', '9'), alpha);
+  if (_mm_movemask_epi8(valid) != 0xFFFF)
+    return false;
+  __m128i nibbles = _mm_add_epi8(_mm_and_si128(chars, _mm_set1_epi8(0x0F)),
+                                 _mm_and_si128(alpha, _mm_set1_epi8(9)));
+  __m128i words = _mm_or_si128(_mm_slli_epi16(nibbles, 4),
+                               _mm_srli_epi16(nibbles, 8));
+  words = _mm_and_si128(words, _mm_set1_epi16(0x00FF));
+  uint64_t bytes;
+  _mm_storel_epi64(reinterpret_cast<__m128i *>(&bytes),
+                   _mm_packus_epi16(words, words));
+  value = __builtin_bswap64(bytes);
+  return true;
+}
+
+
+__attribute__((target("avx2")))
+inline __m256i in_range_avx2(__m256i chars, char low, char high) {
+  return _mm256_and_si256(
+    _mm256_cmpgt_epi8(chars, _mm256_set1_epi8(low - 1)),
+    _mm256_cmpgt_epi8(_mm256_set1_epi8(high + 1), chars));
+}
+
+__attribute__((target("avx2")))
+const char *avx2_spaces(const char *cursor, const char *end) {
+  for (; end - cursor >= 32; cursor += 32) {
+    __m256i chars =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(cursor));
+    __m256i match = _mm256_or_si256(
+      _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(' ')),
+      in_range_avx2(chars, '\t', '\r'));
+    unsigned mismatch = ~static_cast<unsigned>(_mm256_movemask_epi8(match));
+    if (mismatch)
+      return cursor + __builtin_ctz(mismatch);
+  }
+  return sse2_spaces(cursor, end);
+}
+
+__attribute__((target("avx2")))
+const char *avx2_digits(const char *cursor, const char *end) {
+  for (; end - cursor >= 32; cursor += 32) {
+    __m256i chars =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(cursor));
+    __m256i match = in_range_avx2(chars, '0', '9');
+    unsigned mismatch = ~static_cast<unsigned>(_mm256_movemask_epi8(match));
+    if (mismatch)
+      return cursor + __builtin_ctz(mismatch);
+  }
+  return sse2_digits(cursor, end);
+}
+
+
+// Bytes are compared as unsigned values: a character is in the range if its
+// difference with the range start does not exceed the range width.
+
+__attribute__((target("avx512f,avx512bw")))
+inline __mmask64 in_range_avx512(__m512i chars, char low, char high) {
+  return _mm512_cmple_epu8_mask(_mm512_sub_epi8(chars, _mm512_set1_epi8(low)),
+                                _mm512_set1_epi8(high - low));
+}
+
+__attribute__((target("avx512f,avx512bw")))
+const char *avx512_spaces(const char *cursor, const char *end) {
+  for (; end - cursor >= 64; cursor += 64) {
+    __m512i chars = _mm512_loadu_si512(cursor);
+    uint64_t match = _mm512_cmpeq_epi8_mask(chars, _mm512_set1_epi8(' ')) |
+                     in_range_avx512(chars, '\t', '\r');
+    if (~match)
+      return cursor + __builtin_ctzll(~match);
+  }
+  return avx2_spaces(cursor, end);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+const char *avx512_digits(const char *cursor, const char *end) {
+  for (; end - cursor >= 64; cursor += 64) {
+    __m512i chars = _mm512_loadu_si512(cursor);
+    uint64_t match = in_range_avx512(chars, '0', '9');
+    if (~match)
+      return cursor + __builtin_ctzll(~match);
+  }
+  return avx2_digits(cursor, end);
+}
+
+constexpr Kernel<ScanFunction> spaces_kernel(
+  scalar_spaces, sse2_spaces, nullptr, avx2_spaces, avx512_spaces);
+constexpr Kernel<ScanFunction> digits_kernel(
+  scalar_digits, sse2_digits, nullptr, avx2_digits, avx512_digits);
+constexpr Kernel<HexFunction> hex_kernel(scalar_hex, sse2_hex);
+
+#else
+
+constexpr Kernel<ScanFunction> spaces_kernel(scalar_spaces);
+constexpr Kernel<ScanFunction> digits_kernel(scalar_digits);
+constexpr Kernel<HexFunction> hex_kernel(scalar_hex);
+
+#endif
+
+}
+
+
+const char *scan_spaces_vector(const char *cursor, const char *end) {
+  return spaces_kernel.get()(cursor, end);
+}
+
+
+const char *scan_digits_vector(const char *cursor, const char *end) {
+  return digits_kernel.get()(cursor, end);
+}
+
+
+
+bool parse_sixteen_hex_digits(const char *str, uint64_t &value) {
+  return hex_kernel.get()(str, value);
+}
+
+}
+}
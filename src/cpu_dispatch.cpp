@@ -0,0 +1,154 @@
+//===--- cpu_dispatch.cpp ---------------------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Detection of instruction set level supported by the processor.
+///
+//===----------------------------------------------------------------------===//
+
+//------ Dependencies ----------------------------------------------------------
+#include "conversion/cpu_dispatch.h"
+#include <atomic>
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+    defined(_M_IX86)
+#define CONVERSION_X86 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+//------------------------------------------------------------------------------
+
+namespace conversion {
+
+namespace {
+
+#if defined(CONVERSION_X86) && defined(_MSC_VER) && !defined(__clang__)
+
+CpuLevel probe_cpu_level() {
+  int info[4];
+  __cpuid(info, 0);
+  int max_leaf = info[0];
+  __cpuid(info, 1);
+  int ecx1 = info[2], edx1 = info[3];
+  if (!(edx1 & (1 << 26)))
+    return ScalarLevel;
+  if (!(ecx1 & (1 << 20)))
+    return SSE2Level;
+
+  // AVX state must be enabled by operating system.
+  bool osxsave = (ecx1 & (1 << 27)) != 0;
+  unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+  if (max_leaf < 7 || (xcr0 & 0x6) != 0x6)
+    return SSE42Level;
+  __cpuidex(info, 7, 0);
+  int ebx7 = info[1];
+  if (!(ebx7 & (1 << 5)))
+    return SSE42Level;
+  bool avx512 = (ebx7 & (1 << 16)) && (ebx7 & (1 << 30));
+  if (!avx512 || (xcr0 & 0xE6) != 0xE6)
+    return AVX2Level;
+  return AVX512Level;
+}
+
+#elif defined(CONVERSION_X86) && defined(__GNUC__)
+
+CpuLevel probe_cpu_level() {
+  // The builtins also check that the operating system saves vector registers.
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+    return AVX512Level;
+  if (__builtin_cpu_supports("avx2"))
+    return AVX2Level;
+  if (__builtin_cpu_supports("sse4.2"))
+    return SSE42Level;
+  if (__builtin_cpu_supports("sse2"))
+    return SSE2Level;
+  return ScalarLevel;
+}
+
+#else
+
+CpuLevel probe_cpu_level() {
+  return ScalarLevel;
+}
+
+#endif
+
+
+// Level used by kernels, negative value means that it is not determined yet.
+// It is determined at the first use, as static constructors of other
+// translation units may call kernels before constructors of this one run.
+std::atomic<int> current_level(-1);
+
+// Makes the probe at startup, so that it does not happen in a time-critical
+// code.
+const CpuLevel startup_level = get_cpu_level();
+
+}
+
+
+CpuLevel detect_cpu_level() {
+  static const CpuLevel detected = probe_cpu_level();
+  return detected;
+}
+
+
+CpuLevel get_cpu_level() {
+  int level = current_level.load(std::memory_order_relaxed);
+  if (level < 0) {
+    level = detect_cpu_level();
+    current_level.store(level, std::memory_order_relaxed);
+  }
+  return static_cast<CpuLevel>(level);
+}
+
+
+bool set_cpu_level(CpuLevel level) {
+  if (level < ScalarLevel || level > detect_cpu_level())
+    return false;
+  current_level.store(level, std::memory_order_relaxed);
+  return true;
+}
+
+
+void reset_cpu_level() {
+  current_level.store(detect_cpu_level(), std::memory_order_relaxed);
+}
+
+
+const char *get_cpu_level_name(CpuLevel level) {
+  static const char *const names[CpuLevelCount] = {
+    "scalar", "sse2", "sse4.2", "avx2", "avx512"
+  };
+  if (level < ScalarLevel || level >= CpuLevelCount)
+    return "unknown";
+  return names[level];
+}
+
+}
@@ -0,0 +1,156 @@
+//===--- mapped_file.cpp ----------------------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Implementation of memory mapped files.
+///
+//===----------------------------------------------------------------------===//
+
+//------ Dependencies ----------------------------------------------------------
+#include "conversion/mapped_file.h"
+#include <errno.h>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+//------------------------------------------------------------------------------
+
+namespace conversion {
+
+MappedFile &MappedFile::operator=(MappedFile &&other) {
+  if (this != &other) {
+    close();
+    start = other.start;
+    length = other.length;
+    error_code = other.error_code;
+    other.start = nullptr;
+    other.length = 0;
+  }
+  return *this;
+}
+
+
+#if defined(_WIN32)
+
+bool MappedFile::open(const char *path) {
+  close();
+  error_code = 0;
+  HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    error_code = static_cast<int>(GetLastError());
+    return false;
+  }
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size)) {
+    error_code = static_cast<int>(GetLastError());
+    CloseHandle(file);
+    return false;
+  }
+  if (file_size.QuadPart == 0) {
+    CloseHandle(file);
+    return true;
+  }
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0,
+                                      nullptr);
+  if (!mapping) {
+    error_code = static_cast<int>(GetLastError());
+    CloseHandle(file);
+    return false;
+  }
+  void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (!view)
+    error_code = static_cast<int>(GetLastError());
+  CloseHandle(mapping);
+  CloseHandle(file);
+  if (!view)
+    return false;
+  start = static_cast<const char *>(view);
+  length = static_cast<size_t>(file_size.QuadPart);
+  return true;
+}
+
+
+void MappedFile::close() {
+  if (start)
+    UnmapViewOfFile(start);
+  start = nullptr;
+  length = 0;
+}
+
+#else
+
+bool MappedFile::open(const char *path) {
+  close();
+  error_code = 0;
+  int fd = ::open(path, O_RDONLY);
+  if (fd < 0) {
+    error_code = errno;
+    return false;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    error_code = errno;
+    ::close(fd);
+    return false;
+  }
+  if (info.st_size == 0) {
+    ::close(fd);
+    return true;
+  }
+  size_t file_size = static_cast<size_t>(info.st_size);
+  void *view = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (view == MAP_FAILED)
+    error_code = errno;
+  ::close(fd);
+  if (view == MAP_FAILED)
+    return false;
+#if defined(MADV_SEQUENTIAL)
+  madvise(view, file_size, MADV_SEQUENTIAL);
+#endif
+  start = static_cast<const char *>(view);
+  length = file_size;
+  return true;
+}
+
+
+void MappedFile::close() {
+  if (start)
+    munmap(const_cast<char *>(start), length);
+  start = nullptr;
+  length = 0;
+}
+
+#endif
+
+}
@@ -35,6 +35,7 @@
 
 //------ Dependencies ----------------------------------------------------------
 #include "conversion/number_recognizer.h"
+#include "conversion/number_formatter.h"
 //------------------------------------------------------------------------------
 
 namespace conversion {
@@ -42,4 +43,16 @@ namespace conversion {
 const char upper_digits[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
 const char lower_digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
 
+const char decimal_pairs[] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
 }
@@ -0,0 +1,222 @@
+//===--- char_scanner_tests.cpp ---------------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Unit tests for character classification and scanning of whitespace and
+/// digit runs.
+///
+//===----------------------------------------------------------------------===//
+
+//------ Dependencies ----------------------------------------------------------
+#include "conversion/number_recognizer.h"
+#include "conversion/cpu_dispatch.h"
+#include <boost/test/unit_test.hpp>
+#include <cctype>
+#include <string>
+//------------------------------------------------------------------------------
+
+using namespace conversion;
+using namespace conversion::internal;
+
+
+// Runs the test for every instruction set level supported by the processor.
+template<typename Test>
+static void for_each_level(Test test) {
+  for (unsigned level = ScalarLevel; level <= detect_cpu_level(); ++level) {
+    BOOST_REQUIRE(set_cpu_level(static_cast<CpuLevel>(level)));
+    BOOST_REQUIRE_EQUAL(get_cpu_level(), level);
+    test();
+  }
+  reset_cpu_level();
+}
+
+
+BOOST_AUTO_TEST_CASE(CharClassTest) {
+  // The table must agree with the "C" locale.
+  for (unsigned code = 0; code < 256; ++code) {
+    char ch = static_cast<char>(code);
+    BOOST_TEST_INFO(code);
+    BOOST_REQUIRE_EQUAL(is_space_char(ch), std::isspace(code) != 0);
+    BOOST_TEST_INFO(code);
+    BOOST_REQUIRE_EQUAL(is_decimal_char(ch), std::isdigit(code) != 0);
+    BOOST_TEST_INFO(code);
+    BOOST_REQUIRE_EQUAL(is_hex_char(ch), std::isxdigit(code) != 0);
+    BOOST_TEST_INFO(code);
+    BOOST_REQUIRE_EQUAL(digit_value(ch) != NotDigit, std::isalnum(code) != 0);
+  }
+  BOOST_REQUIRE_EQUAL(digit_value('0'), 0);
+  BOOST_REQUIRE_EQUAL(digit_value('9'), 9);
+  BOOST_REQUIRE_EQUAL(digit_value('A'), 10);
+  BOOST_REQUIRE_EQUAL(digit_value('z'), 35);
+  BOOST_REQUIRE(is_sign_char('+') && is_sign_char('-') && !is_sign_char('.'));
+  BOOST_REQUIRE(is_exponent_char('e') && is_exponent_char('E'));
+  BOOST_REQUIRE(!is_exponent_char('p') && !is_exponent_char('f'));
+
+  // Wide characters outside of 0..255 do not belong to any class.
+  BOOST_REQUIRE_EQUAL(digit_value(L'5'), 5);
+  BOOST_REQUIRE(is_space_char(L'\t'));
+  BOOST_REQUIRE_EQUAL(digit_value(wchar_t(0x135)), NotDigit);
+  BOOST_REQUIRE(!is_space_char(wchar_t(0x120)));
+  BOOST_REQUIRE(!is_decimal_char(char16_t(0x3030)));
+  BOOST_REQUIRE(!is_hex_char(char32_t(0x10041)));
+}
+
+
+BOOST_AUTO_TEST_CASE(RecognizeTruncatedExponentTest) {
+  // Text is not null terminated, exponent sign is the last character.
+  const char text[] = { '1', 'e', '+', '5' };
+  NumberRecognizer<> Recog(text, 3);
+  BOOST_REQUIRE(Recog.recognize().partial());
+  BOOST_REQUIRE_EQUAL(Recog.get_exp_length(), 0U);
+  BOOST_REQUIRE_EQUAL(Recog.get_rest_start(), 1U);
+
+  Recog.init(text, 4);
+  BOOST_REQUIRE(Recog.recognize().success());
+  BOOST_REQUIRE_EQUAL(Recog.to<double>(), 1e5);
+}
+
+
+BOOST_AUTO_TEST_CASE(CpuLevelTest) {
+  CpuLevel detected = detect_cpu_level();
+  BOOST_REQUIRE_EQUAL(get_cpu_level(), detected);
+  BOOST_REQUIRE(set_cpu_level(ScalarLevel));
+  BOOST_REQUIRE_EQUAL(get_cpu_level(), ScalarLevel);
+  if (detected + 1 < CpuLevelCount) {
+    BOOST_REQUIRE(!set_cpu_level(static_cast<CpuLevel>(detected + 1)));
+    BOOST_REQUIRE_EQUAL(get_cpu_level(), ScalarLevel);
+  }
+  reset_cpu_level();
+  BOOST_REQUIRE_EQUAL(get_cpu_level(), detected);
+  BOOST_REQUIRE_EQUAL(std::string(get_cpu_level_name(ScalarLevel)), "scalar");
+  BOOST_REQUIRE_EQUAL(std::string(get_cpu_level_name(AVX2Level)), "avx2");
+}
+
+
+// Kernel selects implementation of the highest level not exceeding the
+// current one.
+static int impl_scalar() { return 0; }
+static int impl_sse2() { return 1; }
+static int impl_avx2() { return 3; }
+
+BOOST_AUTO_TEST_CASE(KernelSelectionTest) {
+  constexpr Kernel<int (*)()> kernel(impl_scalar, impl_sse2, nullptr,
+                                     impl_avx2);
+  BOOST_REQUIRE_EQUAL(kernel.get(ScalarLevel)(), 0);
+  BOOST_REQUIRE_EQUAL(kernel.get(SSE2Level)(), 1);
+  BOOST_REQUIRE_EQUAL(kernel.get(SSE42Level)(), 1);
+  BOOST_REQUIRE_EQUAL(kernel.get(AVX2Level)(), 3);
+  BOOST_REQUIRE_EQUAL(kernel.get(AVX512Level)(), 3);
+
+  constexpr Kernel<int (*)()> scalar_only(impl_scalar);
+  BOOST_REQUIRE_EQUAL(scalar_only.get(AVX512Level)(), 0);
+}
+
+
+BOOST_AUTO_TEST_CASE(ScanRunsTest) {
+  // Characters that stop or continue the runs. Bytes with high bit set must
+  // not be taken for ASCII characters.
+  const char stoppers[] = { '/', ':', '.', 'e', '\x08', '\x0E', '\x1F', '!',
+                            '\x80', '\xA0', '\xB0', '\xFF', '\0' };
+  for_each_level([&]() {
+    for (unsigned len = 0; len < 80; ++len) {
+      for (unsigned pos = 0; pos <= len; ++pos) {
+        for (char stop : stoppers) {
+          std::string digits(len, '7');
+          std::string spaces;
+          for (unsigned i = 0; i < len; ++i)
+            spaces += " \t\n\v\f\r"[i % 6];
+          if (pos < len) {
+            digits[pos] = stop;
+            spaces[pos] = stop;
+          }
+          const char *begin = digits.data();
+          BOOST_REQUIRE_EQUAL(scan_digits(begin, begin + len) - begin, pos);
+          begin = spaces.data();
+          BOOST_REQUIRE_EQUAL(scan_spaces(begin, begin + len) - begin, pos);
+        }
+      }
+    }
+  });
+}
+
+
+BOOST_AUTO_TEST_CASE(RecognizeLongPartsTest) {
+  for_each_level([]() {
+    std::string spaces(37, ' ');
+    std::string int_part = "123456789012345678901234567890123456789";
+    std::string frac_part = "98765432109876543210987654321098765432100000";
+    std::string text = spaces + int_part + "." + frac_part + "e-0000000000000000"
+                       "000000000000000000012" + spaces + "\t";
+
+    NumberRecognizer<> Recog(text.c_str());
+    BOOST_REQUIRE(Recog.recognize().success());
+    BOOST_REQUIRE_EQUAL(Recog.get_leading_ws(), spaces.size());
+    BOOST_REQUIRE_EQUAL(Recog.get_int_length(), int_part.size());
+    BOOST_REQUIRE_EQUAL(Recog.get_frac_length(), frac_part.size() - 5);
+    BOOST_REQUIRE_EQUAL(Recog.get_exp_length(), 2U);
+    BOOST_REQUIRE_EQUAL(Recog.get_trailing_ws(), spaces.size() + 1);
+    BOOST_REQUIRE_EQUAL(Recog.to<double>(),
+                        1.23456789012345678901234567890123456789e26);
+
+    text = spaces + int_part + "x";
+    Recog.init(text.c_str());
+    BOOST_REQUIRE(Recog.recognize().partial());
+    BOOST_REQUIRE_EQUAL(Recog.get_int_length(), int_part.size());
+    BOOST_REQUIRE_EQUAL(Recog.get_rest_start(), text.size() - 1);
+  });
+}
+
+
+BOOST_AUTO_TEST_CASE(ParseHexDigitsTest) {
+  for_each_level([]() {
+    uint64_t value;
+    BOOST_REQUIRE(parse_sixteen_hex_digits("0123456789abcdef", value));
+    BOOST_REQUIRE_EQUAL(value, 0x0123456789ABCDEFULL);
+    BOOST_REQUIRE(parse_sixteen_hex_digits("FEDCBA9876543210", value));
+    BOOST_REQUIRE_EQUAL(value, 0xFEDCBA9876543210ULL);
+    BOOST_REQUIRE(parse_sixteen_hex_digits("0000000000000000", value));
+    BOOST_REQUIRE_EQUAL(value, 0ULL);
+
+    // Every character in every position must agree with digit_value.
+    for (unsigned code = 0; code < 256; ++code) {
+      for (unsigned pos = 0; pos < 16; ++pos) {
+        char text[] = "fFfFfFfFfFfFfFfF";
+        text[pos] = static_cast<char>(code);
+        bool valid = parse_sixteen_hex_digits(text, value);
+        BOOST_TEST_INFO(code << " at " << pos);
+        BOOST_REQUIRE_EQUAL(valid, is_hex_char(text[pos]));
+        if (valid) {
+          uint64_t expected = ~0ULL ^
+            (uint64_t(15 - digit_value(text[pos])) << (60 - 4 * pos));
+          BOOST_REQUIRE_EQUAL(value, expected);
+        }
+      }
+    }
+  });
+}
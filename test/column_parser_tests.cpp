@@ -0,0 +1,161 @@
+//===--- column_parser_tests.cpp --------------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///  Unit tests for conversion of arrays of strings.
+///
+//===----------------------------------------------------------------------===//
+
+//------ Dependencies ----------------------------------------------------------
+#include "conversion/column_parser.h"
+#include <boost/test/unit_test.hpp>
+#include <string>
+#include <vector>
+//------------------------------------------------------------------------------
+
+using namespace conversion;
+
+
+BOOST_AUTO_TEST_CASE(ParseIntColumnTest) {
+  std::vector<std::string> texts = {
+    "1", " -22 ", "+333", "", "12abc", "2147483647", "2147483648",
+    "-2147483648", "1.5", "1e3", "0x10"
+  };
+  std::vector<int> values(texts.size());
+  std::vector<Status> statuses(texts.size());
+
+  size_t ok_count = parse_column(texts.data(), texts.size(), values.data(),
+                                 statuses.data());
+  BOOST_REQUIRE_EQUAL(ok_count, 7U);
+
+  BOOST_REQUIRE_EQUAL(values[0], 1);
+  BOOST_REQUIRE_EQUAL(statuses[0], OK);
+  BOOST_REQUIRE_EQUAL(values[1], -22);
+  BOOST_REQUIRE_EQUAL(statuses[1], OK);
+  BOOST_REQUIRE_EQUAL(values[2], 333);
+  BOOST_REQUIRE_EQUAL(statuses[2], OK);
+  BOOST_REQUIRE_EQUAL(values[3], 0);
+  BOOST_REQUIRE_EQUAL(statuses[3], NaN);
+  BOOST_REQUIRE_EQUAL(values[4], 0);
+  BOOST_REQUIRE_EQUAL(statuses[4], NaN);
+  BOOST_REQUIRE_EQUAL(values[5], 2147483647);
+  BOOST_REQUIRE_EQUAL(statuses[5], OK);
+  BOOST_REQUIRE_EQUAL(statuses[6], IntOverflow);
+  BOOST_REQUIRE_EQUAL(values[7], -2147483647 - 1);
+  BOOST_REQUIRE_EQUAL(statuses[7], OK);
+  BOOST_REQUIRE_EQUAL(values[8], 1);
+  BOOST_REQUIRE_EQUAL(values[9], 1000);
+  BOOST_REQUIRE_EQUAL(statuses[10], NaN);
+
+  // Status array is optional, options may be specified.
+  values.assign(texts.size(), -1);
+  ok_count = parse_column(texts.data(), texts.size(), values.data(), nullptr,
+                          Prefix0x);
+  BOOST_REQUIRE_EQUAL(ok_count, 6U);
+  BOOST_REQUIRE_EQUAL(values[10], 16);
+  BOOST_REQUIRE_EQUAL(values[8], 0);
+}
+
+
+BOOST_AUTO_TEST_CASE(ParseDoubleColumnTest) {
+  const wchar_t *data = L"0.25 1e-3 x";
+  std::tuple<const wchar_t *, unsigned> texts[] = {
+    std::make_tuple(data, 4U),
+    std::make_tuple(data + 5, 4U),
+    std::make_tuple(data + 10, 1U),
+    std::make_tuple(data, 0U)
+  };
+  double values[4];
+  Status statuses[4];
+  size_t ok_count = parse_column(texts, 4, values, statuses);
+  BOOST_REQUIRE_EQUAL(ok_count, 2U);
+  BOOST_REQUIRE_EQUAL(values[0], 0.25);
+  BOOST_REQUIRE_EQUAL(values[1], 1e-3);
+  BOOST_REQUIRE_EQUAL(statuses[2], NaN);
+  BOOST_REQUIRE_EQUAL(statuses[3], NaN);
+}
+
+
+// Text that reports length not representable by unsigned, its characters
+// must not be accessed beyond the number.
+struct HugeText {
+  const char *data() const { return "12"; }
+  size_t size() const {
+    return size_t(std::numeric_limits<unsigned>::max()) + 3;
+  }
+};
+
+
+BOOST_AUTO_TEST_CASE(ParseHugeElementTest) {
+  if (sizeof(size_t) <= sizeof(unsigned))
+    return;
+  HugeText texts[1];
+  int values[1] = { -1 };
+  Status statuses[1];
+  BOOST_REQUIRE_EQUAL(parse_column(texts, 1, values, statuses), 0U);
+  BOOST_REQUIRE_EQUAL(values[0], 0);
+  BOOST_REQUIRE_EQUAL(statuses[0], NaN);
+}
+
+
+BOOST_AUTO_TEST_CASE(ParseDelimitedTest) {
+  std::string buf = "10,-20, 30 ,abc,,1e2,";
+  BOOST_REQUIRE_EQUAL(count_fields(buf.data(), buf.size(), ','), 6U);
+
+  long values[8];
+  Status statuses[8];
+  size_t count = parse_delimited(buf.data(), buf.size(), ',', values,
+                                 statuses, 8);
+  BOOST_REQUIRE_EQUAL(count, 6U);
+  BOOST_REQUIRE_EQUAL(values[0], 10);
+  BOOST_REQUIRE_EQUAL(values[1], -20);
+  BOOST_REQUIRE_EQUAL(values[2], 30);
+  BOOST_REQUIRE_EQUAL(statuses[2], OK);
+  BOOST_REQUIRE_EQUAL(statuses[3], NaN);
+  BOOST_REQUIRE_EQUAL(statuses[4], NaN);
+  BOOST_REQUIRE_EQUAL(values[5], 100);
+
+  // Output is limited by the size of arrays.
+  count = parse_delimited(buf.data(), buf.size(), ',', values, statuses, 2);
+  BOOST_REQUIRE_EQUAL(count, 2U);
+
+  // Empty buffer and buffer that ends with empty field.
+  BOOST_REQUIRE_EQUAL(parse_delimited(buf.data(), 0, ',', values, statuses, 8),
+                      0U);
+  BOOST_REQUIRE_EQUAL(count_fields(buf.data(), 0, ','), 0U);
+  std::string lines = "1.5\n\n2.5";
+  double dvalues[3];
+  count = parse_delimited(lines.data(), lines.size(), '\n', dvalues, statuses,
+                          3);
+  BOOST_REQUIRE_EQUAL(count, 3U);
+  BOOST_REQUIRE_EQUAL(count_fields(lines.data(), lines.size(), '\n'), 3U);
+  BOOST_REQUIRE_EQUAL(dvalues[0], 1.5);
+  BOOST_REQUIRE_EQUAL(statuses[1], NaN);
+  BOOST_REQUIRE_EQUAL(dvalues[2], 2.5);
+}
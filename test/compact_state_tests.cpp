@@ -0,0 +1,184 @@
+//===--- compact_state_tests.cpp --------------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///  Unit tests for compact form of recognizer state.
+///
+//===----------------------------------------------------------------------===//
+
+//------ Dependencies ----------------------------------------------------------
+#include "conversion/number_recognizer.h"
+#include "recognizer_checks.h"
+#include <boost/test/unit_test.hpp>
+#include <string>
+#include <vector>
+//------------------------------------------------------------------------------
+
+using namespace conversion;
+using namespace conversion::test;
+
+
+// Checks that both objects report the same recognition results, including
+// the parts that the stream recognizer does not compare.
+template<typename StateT>
+static void compare_states(const std::string &text,
+                           const NumberRecognizerState &expected,
+                           const StateT &state) {
+  compare_parts(text, expected, state);
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.size(), expected.size());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.recognized(), expected.recognized());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.is_empty(), expected.is_empty());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.has_plus(), expected.has_plus());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.has_exp_plus(), expected.has_exp_plus());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.get_leading_zeros(), expected.get_leading_zeros());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.get_trailing_zeros(),
+                      expected.get_trailing_zeros());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.get_rest_length(), expected.get_rest_length());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.get_mantissa_length(),
+                      expected.get_mantissa_length());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.get_number_length(),
+                      expected.get_number_length());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.get_prefix_start(), expected.get_prefix_start());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.get_number_start(), expected.get_number_start());
+}
+
+
+static void check_text(const std::string &text, unsigned opts,
+                       unsigned char base = 0) {
+  NumberRecognizer<> whole(text.c_str(), text.size(), opts);
+  whole.set_base(base);
+  whole.recognize();
+
+  CompactRecognizerState compact;
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE(CompactRecognizerState::fits(whole));
+  BOOST_REQUIRE(compact.assign(whole));
+  compare_states(text, whole, compact);
+
+  NumberRecognizer<> restored;
+  restored.init(text.c_str(), compact, opts);
+  compare_states(text, whole, restored);
+  BOOST_REQUIRE_EQUAL(restored.get_options(), whole.get_options());
+  BOOST_REQUIRE_EQUAL(restored.get_status(), whole.get_status());
+
+  compare_values<double>(text, whole, restored);
+  compare_values<float>(text, whole, restored);
+  compare_values<int>(text, whole, restored);
+  compare_values<unsigned long long>(text, whole, restored);
+}
+
+
+BOOST_AUTO_TEST_CASE(CompactStateTest) {
+  const unsigned AllPrefixes = Prefix0x | Prefix0o | Prefix0q | Prefix0b;
+  const unsigned OptionSets[] = {
+    DefaultOptions, 0, AllPrefixes | Floating, AllPrefixes | Prefix0
+  };
+  for (unsigned opts : OptionSets)
+    for (const char *text : RecognizerTestStrings)
+      check_text(text, opts);
+  for (const char *text : RecognizerTestStrings) {
+    check_text(text, AllPrefixes | Floating, 16);
+    check_text(text, DefaultOptions, 2);
+    check_text(text, DefaultOptions, 8);
+  }
+
+  // Unrecognized state.
+  NumberRecognizer<> recog("123");
+  CompactRecognizerState compact;
+  BOOST_REQUIRE(compact.assign(recog));
+  BOOST_REQUIRE(!compact.recognized());
+  NumberRecognizer<> restored;
+  BOOST_REQUIRE_EQUAL(restored.init("123", compact).to<int>(), 123);
+  BOOST_REQUIRE(restored.success());
+}
+
+
+BOOST_AUTO_TEST_CASE(CompactStateLimitsTest) {
+  BOOST_REQUIRE_EQUAL(sizeof(CompactRecognizerState), 16);
+
+  std::string longest = std::string(0xFFFF - 6, ' ') + "-1.5e3";
+  check_text(longest, DefaultOptions);
+  check_text("-" + std::string(254, '0') + "1.25", DefaultOptions);
+  check_text("1e" + std::string(31, '0') + std::string(255, '7'),
+             DefaultOptions);
+
+  const std::string too_long[] = {
+    std::string(0xFFFF - 5, ' ') + "-1.5e3",
+    "-" + std::string(255, '0') + "1.25",
+    "1e" + std::string(32, '0') + "7",
+    "1e" + std::string(256, '7'),
+  };
+  for (const std::string &text : too_long) {
+    NumberRecognizer<> recog(text.c_str(), text.size());
+    recog.recognize();
+    BOOST_TEST_INFO(text.size());
+    BOOST_REQUIRE(!CompactRecognizerState::fits(recog));
+
+    // Object is not changed if the state does not fit.
+    CompactRecognizerState compact;
+    BOOST_REQUIRE(!compact.assign(recog));
+    BOOST_REQUIRE(!compact.recognized());
+    BOOST_REQUIRE_EQUAL(compact.size(), 0);
+  }
+}
+
+
+BOOST_AUTO_TEST_CASE(CompactStateArrayTest) {
+  // Fields are recognized first, conversion is made later for some of them.
+  const char *fields[] = { " 12", "-7.5", "1e3", "x", "0.25 " };
+  std::vector<CompactRecognizerState> states;
+  for (const char *field : fields) {
+    NumberRecognizer<> recog(field);
+    recog.recognize();
+    states.emplace_back();
+    BOOST_REQUIRE(states.back().assign(recog));
+  }
+  BOOST_REQUIRE(states[3].failure());
+  BOOST_REQUIRE_EQUAL(states[4].get_trailing_ws(), 1);
+  BOOST_REQUIRE_EQUAL(states[1].get_frac_start(), 3);
+
+  double sum = 0;
+  NumberRecognizer<> recog;
+  for (size_t i = 0; i < states.size(); ++i)
+    if (!states[i].failure())
+      sum += recog.init(fields[i], states[i]).to<double>();
+  BOOST_REQUIRE_EQUAL(sum, 12 - 7.5 + 1000 + 0.25);
+}
@@ -36,6 +36,7 @@
 #include "conversion/number_recognizer.h"
 #include <boost/test/unit_test.hpp>
 #include <memory>
+#include <string>
 //------------------------------------------------------------------------------
 
 using namespace conversion;
@@ -252,3 +253,207 @@ BOOST_AUTO_TEST_CASE(ConvertErrorTest) {
 
   BOOST_REQUIRE_EQUAL(st, NaN);
 }
+
+
+BOOST_AUTO_TEST_CASE(ConvertDigitGroupsTest) {
+  unsigned long long value;
+  Status st;
+
+  st = convert_int(value, "12345678", 8, 10);
+  BOOST_REQUIRE_EQUAL(st, OK);
+  BOOST_REQUIRE_EQUAL(value, 12345678ULL);
+
+  st = convert_int(value, "1234567890123456", 16, 10);
+  BOOST_REQUIRE_EQUAL(st, OK);
+  BOOST_REQUIRE_EQUAL(value, 1234567890123456ULL);
+
+  st = convert_int(value, "0000000000000000001", 19, 10);
+  BOOST_REQUIRE_EQUAL(st, OK);
+  BOOST_REQUIRE_EQUAL(value, 1ULL);
+
+  st = convert_int(value, "9999999999999999999", 19, 10);
+  BOOST_REQUIRE_EQUAL(st, OK);
+  BOOST_REQUIRE_EQUAL(value, 9999999999999999999ULL);
+
+  st = convert_int(value, "99999999999999999999", 20, 10);
+  BOOST_REQUIRE_EQUAL(st, IntOverflow);
+
+  int ivalue;
+  st = convert_int(ivalue, "2147483647", 10, 10);
+  BOOST_REQUIRE_EQUAL(st, OK);
+  BOOST_REQUIRE_EQUAL(ivalue, 2147483647);
+
+  st = convert_int(ivalue, "0000000000002147483647", 22, 10);
+  BOOST_REQUIRE_EQUAL(st, OK);
+  BOOST_REQUIRE_EQUAL(ivalue, 2147483647);
+
+  // Characters adjacent to digits in ASCII table, placed in every position.
+  const char *bad_chars = "/:`\x80\xB0 ";
+  for (const char *bad = bad_chars; *bad; ++bad) {
+    for (unsigned pos = 0; pos < 20; ++pos) {
+      char text[] = "12345678901234567890";
+      text[pos] = *bad;
+      value = 0;
+      st = convert_int(value, text, 19, 10);
+      if (pos < 19)
+        BOOST_REQUIRE_EQUAL(st, NaN);
+      else
+        BOOST_REQUIRE_EQUAL(st, OK);
+    }
+  }
+
+  // Wide characters use digit by digit conversion.
+  st = convert_int(value, L"1234567890123456789", 19, 10);
+  BOOST_REQUIRE_EQUAL(st, OK);
+  BOOST_REQUIRE_EQUAL(value, 1234567890123456789ULL);
+}
+
+
+BOOST_AUTO_TEST_CASE(ConvertOverflowCheckTest) {
+  Status st;
+
+  signed char scvalue;
+  st = convert_int(scvalue, "1111111", 7, 2);
+  BOOST_REQUIRE_EQUAL(st, OK);
+  BOOST_REQUIRE_EQUAL(scvalue, 127);
+  st = convert_int(scvalue, "10000000", 8, 2);
+  BOOST_REQUIRE_EQUAL(st, NegativeLimit);
+  st = convert_int(scvalue, "10000001", 8, 2);
+  BOOST_REQUIRE_EQUAL(st, IntOverflow);
+  BOOST_REQUIRE_EQUAL(scvalue, 127);
+  st = convert_int(scvalue, "0000000001111111", 16, 2);
+  BOOST_REQUIRE_EQUAL(st, OK);
+  BOOST_REQUIRE_EQUAL(scvalue, 127);
+
+  unsigned char ucvalue;
+  st = convert_int(ucvalue, "ff", 2, 16);
+  BOOST_REQUIRE_EQUAL(st, OK);
+  BOOST_REQUIRE_EQUAL(ucvalue, 255);
+  st = convert_int(ucvalue, "100", 3, 16);
+  BOOST_REQUIRE_EQUAL(st, IntOverflow);
+  BOOST_REQUIRE_EQUAL(ucvalue, 255);
+
+  int ivalue;
+  st = convert_int(ivalue, "7FFFFFFF", 8, 16);
+  BOOST_REQUIRE_EQUAL(st, OK);
+  BOOST_REQUIRE_EQUAL(ivalue, 2147483647);
+  st = convert_int(ivalue, "80000000", 8, 16);
+  BOOST_REQUIRE_EQUAL(st, NegativeLimit);
+  st = convert_int(ivalue, "80000001", 8, 16);
+  BOOST_REQUIRE_EQUAL(st, IntOverflow);
+  st = convert_int(ivalue, "zik0zj", 6, 36);
+  BOOST_REQUIRE_EQUAL(st, OK);
+  BOOST_REQUIRE_EQUAL(ivalue, 2147483647);
+  st = convert_int(ivalue, "zik0zk", 6, 36);
+  BOOST_REQUIRE_EQUAL(st, NegativeLimit);
+  st = convert_int(ivalue, "zik0zl", 6, 36);
+  BOOST_REQUIRE_EQUAL(st, IntOverflow);
+
+  unsigned long long ullvalue;
+  st = convert_int(ullvalue, "1777777777777777777777", 22, 8);
+  BOOST_REQUIRE_EQUAL(st, OK);
+  BOOST_REQUIRE_EQUAL(ullvalue, 18446744073709551615ULL);
+  st = convert_int(ullvalue, "2000000000000000000000", 22, 8);
+  BOOST_REQUIRE_EQUAL(st, IntOverflow);
+  st = convert_int(ullvalue, "18446744073709551616", 20, 10);
+  BOOST_REQUIRE_EQUAL(st, IntOverflow);
+
+  long long llvalue;
+  st = convert_int(llvalue, "9223372036854775808", 19, 10);
+  BOOST_REQUIRE_EQUAL(st, NegativeLimit);
+  st = convert_int(llvalue, "9223372036854775809", 19, 10);
+  BOOST_REQUIRE_EQUAL(st, IntOverflow);
+  BOOST_REQUIRE_EQUAL(llvalue, 9223372036854775807LL);
+}
+
+
+// Writes value in the specified base, padded with zeros to the given width.
+static std::string to_base(unsigned long long value, unsigned base,
+                           unsigned width = 1) {
+  std::string result;
+  for (; value || result.size() < width; value /= base)
+    result.insert(result.begin(), "0123456789abcdefghijklmnopqrstuv"[value %
+                                                                      base]);
+  return result;
+}
+
+
+template<typename IntType>
+static void do_power2_tests() {
+  typedef std::numeric_limits<IntType> limits;
+  const unsigned long long max = limits::max();
+  for (unsigned base = 2; base <= 32; base *= 2) {
+    for (unsigned width : { 1U, 17U, 70U }) {
+      // Values above max wrap around for unsigned 64-bit type, they remain
+      // valid numbers.
+      for (unsigned long long number : { 0ULL, 1ULL, max / 3, max - 1, max,
+                                         max + 1, max + 2, 2 * max + 1 }) {
+        std::string text = to_base(number, base, width);
+        BOOST_TEST_INFO(text << " base " << base);
+        IntType value = 100;
+        Status st = convert_int(value, text.c_str(), text.size(), base);
+        if (number <= max) {
+          BOOST_REQUIRE_EQUAL(st, OK);
+          BOOST_REQUIRE(static_cast<unsigned long long>(value) == number);
+        } else if (number == max + 1 && limits::is_signed) {
+          BOOST_REQUIRE_EQUAL(st, NegativeLimit);
+        } else {
+          BOOST_REQUIRE_EQUAL(st, IntOverflow);
+          BOOST_REQUIRE(value == limits::max());
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ConvertPowerOfTwoBaseTest) {
+  do_power2_tests<signed char>();
+  do_power2_tests<unsigned char>();
+  do_power2_tests<short>();
+  do_power2_tests<int>();
+  do_power2_tests<unsigned>();
+  do_power2_tests<long long>();
+  do_power2_tests<unsigned long long>();
+
+  // Sixteen leading hexadecimal digits are converted at once.
+  unsigned long long value;
+  Status st = convert_int(value, "0123456789abcDEF", 16, 16);
+  BOOST_REQUIRE_EQUAL(st, OK);
+  BOOST_REQUIRE_EQUAL(value, 0x0123456789ABCDEFULL);
+  st = convert_int(value, "00000000000000000000FfFfFfFfFfFfFfFf", 36, 16);
+  BOOST_REQUIRE_EQUAL(st, OK);
+  BOOST_REQUIRE_EQUAL(value, 0xFFFFFFFFFFFFFFFFULL);
+  st = convert_int(value, "10000000000000000", 17, 16);
+  BOOST_REQUIRE_EQUAL(st, IntOverflow);
+  st = convert_int(value, "1000000000000000g", 17, 16);
+  BOOST_REQUIRE_EQUAL(st, NaN);
+
+  long long llvalue;
+  st = convert_int(llvalue, "8000000000000000", 16, 16);
+  BOOST_REQUIRE_EQUAL(st, NegativeLimit);
+  st = convert_int(llvalue, "8000000000000000g", 17, 16);
+  BOOST_REQUIRE_EQUAL(st, IntOverflow);
+  st = convert_int(llvalue, "80000000000000000", 17, 16);
+  BOOST_REQUIRE_EQUAL(st, IntOverflow);
+  BOOST_REQUIRE_EQUAL(llvalue, 9223372036854775807LL);
+  int ivalue;
+  st = convert_int(ivalue, "0000000080000000", 16, 16);
+  BOOST_REQUIRE_EQUAL(st, NegativeLimit);
+
+  // Characters adjacent to digits and letters in ASCII table, placed in every
+  // position.
+  const char *bad_chars = "/:@G`g\x80\xC1\xE1 ";
+  for (const char *bad = bad_chars; *bad; ++bad) {
+    for (unsigned pos = 0; pos < 20; ++pos) {
+      char text[] = "0000123456789aBcDeF0";
+      text[pos] = *bad;
+      st = convert_int(value, text, 19, 16);
+      BOOST_REQUIRE_EQUAL(st, pos < 19 ? NaN : OK);
+    }
+  }
+
+  // Wide characters use digit by digit conversion.
+  st = convert_int(value, L"0123456789abcdef", 16, 16);
+  BOOST_REQUIRE_EQUAL(st, OK);
+  BOOST_REQUIRE_EQUAL(value, 0x0123456789ABCDEFULL);
+}
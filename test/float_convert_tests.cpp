@@ -0,0 +1,354 @@
+//===--- float_convert_tests.cpp --------------------------------*- C++ -*-===//
+//
+// Copyright(c) 2016-2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Unit tests for conversion of decimal digits into float numbers.
+///
+//===----------------------------------------------------------------------===//
+
+//------ Dependencies ----------------------------------------------------------
+#include "conversion/number_recognizer.h"
+#include <boost/test/unit_test.hpp>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+//------------------------------------------------------------------------------
+
+using namespace conversion;
+
+
+static const char *TrickyNumbers[] = {
+  "0.1",
+  "-0.1",
+  "1.2",
+  "123.456",
+  "3.14159265358979323846",
+  "9007199254740992",
+  "9007199254740993",
+  "9007199254740995",
+  "18014398509481985",
+  "123456789012345678901234567890",
+  "1.00000000000000011102230246251565404236316680908203125",
+  "1.00000000000000011102230246251565404236316680908203124",
+  "1.00000000000000011102230246251565404236316680908203126",
+  "2.2250738585072011e-308",
+  "2.2250738585072012e-308",
+  "2.2250738585072014e-308",
+  "4.9406564584124654e-324",
+  "2.4703282292062327e-324",
+  "2.4703282292062328e-324",
+  "1.7976931348623157e308",
+  "1.7976931348623158e308",
+  "8.98846567431158e307",
+  "1e23",
+  "1e22",
+  "8.589973e9",
+  "7.038531e-26",
+  "1.1754943508e-38",
+  "3.4028234664e38",
+  "1.4012984643e-45",
+  "0.000000000000000000000000000000000000000000001",
+  "4.35679e-10",
+  "2.9802322387695312e-8",
+  "179769313486231570814527423731704356798070567525844996598917476803157260780"
+  "028538760589558632766878171540458953514382464234321326889464182768467546703"
+  "537516986049910576551282076245490090389328944075868508455133942304583236903"
+  "222948165808559332123348274797826204144723168738177180919299881250404026184"
+  "124858368.0",
+};
+
+
+BOOST_AUTO_TEST_CASE(ConvertFloatPartsTest) {
+  double value;
+  Status st;
+
+  st = convert_float(value, "12", 2, "5", 1, 0, false);
+  BOOST_REQUIRE_EQUAL(st, OK);
+  BOOST_REQUIRE_EQUAL(value, 12.5);
+
+  st = convert_float(value, "12", 2, "5", 1, -3, true);
+  BOOST_REQUIRE_EQUAL(st, OK);
+  BOOST_REQUIRE_EQUAL(value, -0.0125);
+
+  st = convert_float(value, "", 0, "0001", 4, 2, false);
+  BOOST_REQUIRE_EQUAL(st, OK);
+  BOOST_REQUIRE_EQUAL(value, 0.01);
+
+  st = convert_float(value, "0", 1, "", 0, 100, true);
+  BOOST_REQUIRE_EQUAL(st, OK);
+  BOOST_REQUIRE_EQUAL(value, 0);
+  BOOST_REQUIRE(signbit(value));
+
+  st = convert_float(value, "1", 1, "", 0, 400, false);
+  BOOST_REQUIRE_EQUAL(st, DoubleOverflow);
+  BOOST_REQUIRE_EQUAL(value, std::numeric_limits<double>::max());
+
+  st = convert_float(value, "1", 1, "", 0, 400, true);
+  BOOST_REQUIRE_EQUAL(st, DoubleOverflowNegative);
+  BOOST_REQUIRE_EQUAL(value, -std::numeric_limits<double>::max());
+
+  st = convert_float(value, "1", 1, "", 0, -400, false);
+  BOOST_REQUIRE_EQUAL(st, DoubleUnderflow);
+  BOOST_REQUIRE_EQUAL(value, 0);
+
+  float fvalue;
+  st = convert_float(fvalue, "1", 1, "", 0, 39, false);
+  BOOST_REQUIRE_EQUAL(st, DoubleOverflow);
+  BOOST_REQUIRE_EQUAL(fvalue, std::numeric_limits<float>::max());
+
+  st = convert_float(fvalue, "3", 1, "25", 2, 0, false);
+  BOOST_REQUIRE_EQUAL(st, OK);
+  BOOST_REQUIRE_EQUAL(fvalue, 3.25F);
+
+  st = convert_float(value, std::make_tuple("7", 1U), std::make_tuple("5", 1U),
+                     1, false);
+  BOOST_REQUIRE_EQUAL(st, OK);
+  BOOST_REQUIRE_EQUAL(value, 75.0);
+}
+
+
+BOOST_AUTO_TEST_CASE(ReadDoubleTrickyTest) {
+  NumberRecognizer<> Recog;
+  for (const char *text : TrickyNumbers) {
+    double expected = strtod(text, nullptr);
+    double value = 111;
+    Recog.init(text).read(value);
+    BOOST_TEST_INFO(text);
+    BOOST_REQUIRE(memcmp(&value, &expected, sizeof(value)) == 0);
+  }
+}
+
+
+BOOST_AUTO_TEST_CASE(ReadFloatTrickyTest) {
+  NumberRecognizer<> Recog;
+  for (const char *text : TrickyNumbers) {
+    float expected = strtof(text, nullptr);
+    if (isinf(expected) || expected == 0)
+      continue;
+    float value = 111;
+    BOOST_TEST_INFO(text);
+    BOOST_REQUIRE(Recog.init(text).read(value) == OK);
+    BOOST_TEST_INFO(text);
+    BOOST_REQUIRE(memcmp(&value, &expected, sizeof(value)) == 0);
+  }
+}
+
+
+BOOST_AUTO_TEST_CASE(ReadWideDoubleTest) {
+  NumberRecognizer<wchar_t> Recog;
+  BOOST_REQUIRE_EQUAL(Recog.init(L"-6.02214076e23").to<double>(),
+                      -6.02214076e23);
+  BOOST_REQUIRE_EQUAL(Recog.init(L"  0.000125 ").to<double>(), 0.000125);
+  BOOST_REQUIRE_EQUAL(Recog.init(L"2.5e-1").to<float>(), 0.25F);
+}
+
+
+// Generates random numbers in textual form and compares results of conversion
+// with the values produced by the C library.
+static std::string make_random_number(unsigned &seed, int max_exp) {
+  auto next = [&seed]() {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) & 0xFFFF;
+  };
+  std::string text;
+  unsigned int_digits = next() % 12;
+  unsigned frac_digits = next() % 24;
+  if (int_digits == 0 && frac_digits == 0)
+    int_digits = 1;
+  for (unsigned i = 0; i < int_digits; ++i)
+    text += char('0' + next() % 10);
+  if (frac_digits) {
+    text += '.';
+    for (unsigned i = 0; i < frac_digits; ++i)
+      text += char('0' + next() % 10);
+  }
+  int exp = int(next() % (2 * max_exp + 1)) - max_exp;
+  text += 'e';
+  text += std::to_string(exp);
+  return text;
+}
+
+
+BOOST_AUTO_TEST_CASE(ReadRandomDoubleTest) {
+  NumberRecognizer<> Recog;
+  unsigned seed = 12345;
+  for (unsigned i = 0; i < 20000; ++i) {
+    std::string text = make_random_number(seed, 300);
+    double expected = strtod(text.c_str(), nullptr);
+    double value = Recog.init(text.c_str()).to<double>();
+    BOOST_TEST_INFO(text);
+    if (isinf(expected))
+      BOOST_REQUIRE(Recog.get_status() == DoubleOverflow);
+    else
+      BOOST_REQUIRE(memcmp(&value, &expected, sizeof(value)) == 0);
+  }
+}
+
+
+BOOST_AUTO_TEST_CASE(ReadRandomFloatTest) {
+  NumberRecognizer<> Recog;
+  unsigned seed = 54321;
+  for (unsigned i = 0; i < 20000; ++i) {
+    std::string text = make_random_number(seed, 30);
+    float expected = strtof(text.c_str(), nullptr);
+    float value = Recog.init(text.c_str()).to<float>();
+    BOOST_TEST_INFO(text);
+    if (isinf(expected))
+      BOOST_REQUIRE(Recog.get_status() == DoubleOverflow);
+    else
+      BOOST_REQUIRE(memcmp(&value, &expected, sizeof(value)) == 0);
+  }
+}
+
+
+BOOST_AUTO_TEST_CASE(ComputeFloatTest) {
+  internal::BinaryFloat bin;
+
+  bin = internal::compute_float<double>(0, 1);
+  BOOST_REQUIRE_EQUAL(bin.mantissa, 0);
+  BOOST_REQUIRE_EQUAL(bin.power2, 1023);
+
+  bin = internal::compute_float<double>(-1, 15);
+  BOOST_REQUIRE_EQUAL(bin.mantissa, uint64_t(1) << 51);
+  BOOST_REQUIRE_EQUAL(bin.power2, 1023);
+
+  bin = internal::compute_float<double>(-400, 1);
+  BOOST_REQUIRE_EQUAL(bin.mantissa, 0);
+  BOOST_REQUIRE_EQUAL(bin.power2, 0);
+
+  bin = internal::compute_float<double>(309, 1);
+  BOOST_REQUIRE_EQUAL(bin.mantissa, 0);
+  BOOST_REQUIRE_EQUAL(bin.power2, 0x7FF);
+
+  bin = internal::compute_float<float>(-1, 25);
+  BOOST_REQUIRE_EQUAL(bin.mantissa, uint64_t(1) << 21);
+  BOOST_REQUIRE_EQUAL(bin.power2, 128);
+}
+
+
+// Numbers exactly halfway between two adjacent doubles. They are exactly
+// representable in long double if it has 64-bit mantissa, and printing them
+// with enough digits produces exact decimal representation.
+BOOST_AUTO_TEST_CASE(ReadHalfwayDoubleTest) {
+  if (std::numeric_limits<long double>::digits < 64)
+    return;
+  NumberRecognizer<> Recog;
+  unsigned seed = 777;
+  char buffer[1024];
+  for (unsigned i = 0; i < 2000; ++i) {
+    seed = seed * 1103515245 + 12345;
+    uint64_t bits = (uint64_t(seed) << 32) ^ (uint64_t(seed) * 2654435761U);
+    bits &= ~(uint64_t(1) << 63);
+    if ((bits >> 52) >= 0x7FE)
+      continue;
+    double lower;
+    memcpy(&lower, &bits, sizeof(lower));
+    double upper = nextafter(lower, 1e308);
+    long double halfway = ((long double)lower + (long double)upper) / 2;
+    snprintf(buffer, sizeof(buffer), "%.800Le", halfway);
+    double expected = strtod(buffer, nullptr);
+    double value = Recog.init(buffer).to<double>();
+    BOOST_TEST_INFO(buffer);
+    BOOST_REQUIRE(memcmp(&value, &expected, sizeof(value)) == 0);
+
+    // Slightly above halfway, the difference is far beyond 19 digits.
+    std::string text(buffer);
+    size_t exp_pos = text.find('e');
+    std::string above = text.substr(0, exp_pos) + "0001" + text.substr(exp_pos);
+    expected = strtod(above.c_str(), nullptr);
+    value = Recog.init(above.c_str()).to<double>();
+    BOOST_TEST_INFO(above);
+    BOOST_REQUIRE(memcmp(&value, &expected, sizeof(value)) == 0);
+
+    // Slightly below halfway.
+    std::string below = text.substr(0, 40) + text.substr(exp_pos);
+    expected = strtod(below.c_str(), nullptr);
+    value = Recog.init(below.c_str()).to<double>();
+    BOOST_TEST_INFO(below);
+    BOOST_REQUIRE(memcmp(&value, &expected, sizeof(value)) == 0);
+  }
+}
+
+
+BOOST_AUTO_TEST_CASE(ReadLongExponentTest) {
+  NumberRecognizer<> Recog;
+  double value;
+
+  std::string text = "0." + std::string(1000, '0') + "1e1000";
+  BOOST_REQUIRE_EQUAL(Recog.init(text.c_str()).read(value), OK);
+  BOOST_REQUIRE_EQUAL(value, 0.1);
+
+  text = "1" + std::string(1000, '0') + "e-1000";
+  BOOST_REQUIRE_EQUAL(Recog.init(text.c_str()).read(value), OK);
+  BOOST_REQUIRE_EQUAL(value, 1.0);
+
+  text = "0." + std::string(400, '0') + "1e400";
+  BOOST_REQUIRE_EQUAL(Recog.init(text.c_str()).read(value), OK);
+  BOOST_REQUIRE_EQUAL(value, 0.1);
+
+  BOOST_REQUIRE_EQUAL(Recog.init("0.001e309").read(value), OK);
+  BOOST_REQUIRE_EQUAL(value, 1e306);
+
+  BOOST_REQUIRE_EQUAL(Recog.init("1e-5000").read(value), DoubleUnderflow);
+  BOOST_REQUIRE_EQUAL(value, 0);
+
+  BOOST_REQUIRE_EQUAL(Recog.init("-1e99999999999999").read(value),
+                      DoubleOverflowNegative);
+  BOOST_REQUIRE_EQUAL(value, -std::numeric_limits<double>::max());
+
+  BOOST_REQUIRE_EQUAL(Recog.init("1e-99999999999999").read(value),
+                      DoubleUnderflow);
+  BOOST_REQUIRE_EQUAL(value, 0);
+
+  float fvalue;
+  BOOST_REQUIRE_EQUAL(Recog.init("1e-5000").read(fvalue), DoubleUnderflow);
+  BOOST_REQUIRE_EQUAL(fvalue, 0);
+  BOOST_REQUIRE_EQUAL(Recog.init("1e5000").read(fvalue), DoubleOverflow);
+  BOOST_REQUIRE_EQUAL(fvalue, std::numeric_limits<float>::max());
+}
+
+
+BOOST_AUTO_TEST_CASE(ReadLongMantissaFloatTest) {
+  NumberRecognizer<> Recog;
+  unsigned seed = 4242;
+  char buffer[256];
+  for (unsigned i = 0; i < 2000; ++i) {
+    seed = seed * 1103515245 + 12345;
+    uint32_t bits = seed & 0x7F7FFFFF;
+    float lower;
+    memcpy(&lower, &bits, sizeof(lower));
+    float upper = nextafterf(lower, 1e38F);
+    double halfway = ((double)lower + (double)upper) / 2;
+    snprintf(buffer, sizeof(buffer), "%.150e", halfway);
+    float expected = strtof(buffer, nullptr);
+    float value = Recog.init(buffer).to<float>();
+    BOOST_TEST_INFO(buffer);
+    BOOST_REQUIRE(memcmp(&value, &expected, sizeof(value)) == 0);
+  }
+}
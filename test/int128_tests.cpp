@@ -0,0 +1,212 @@
+//===--- int128_tests.cpp ---------------------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Unit tests for conversion of text to 128-bit integer types.
+///
+//===----------------------------------------------------------------------===//
+
+//------ Dependencies ----------------------------------------------------------
+#include "conversion/number_recognizer.h"
+#include <boost/test/unit_test.hpp>
+#include <string>
+//------------------------------------------------------------------------------
+
+#ifdef CONVERSION_HAS_INT128
+
+using namespace conversion;
+
+typedef __int128 Int128;
+typedef unsigned __int128 UInt128;
+
+static UInt128 make_u128(uint64_t high, uint64_t low) {
+  return (static_cast<UInt128>(high) << 64) | low;
+}
+
+static const UInt128 UMax = ~UInt128(0);
+static const Int128 IMax = static_cast<Int128>(UMax >> 1);
+static const Int128 IMin = -IMax - 1;
+
+
+// Value is not checked if convert_int returns NegativeLimit or NaN, it is
+// unspecified in these cases.
+template<typename NumType>
+static void check_int(const char *text, NumType expected,
+                      Status expected_status, unsigned base = 10) {
+  NumType value;
+  Status status = convert_int(value, text, std::char_traits<char>::length(text),
+                              base);
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(status, expected_status);
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE(value == expected || status == NegativeLimit || status == NaN);
+}
+
+
+template<typename NumType>
+static void check_read(const char *text, NumType expected,
+                       Status expected_status) {
+  NumberRecognizer<> Recog(Floating | Prefix0x);
+  Recog.recognize(text);
+  NumType value;
+  Status status = Recog.read(value);
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE(value == expected);
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(status, expected_status);
+}
+
+
+BOOST_AUTO_TEST_CASE(Int128ConvertTest) {
+  check_int<UInt128>("0", 0, OK);
+  check_int<UInt128>("1234567890123456789", 1234567890123456789ULL, OK);
+  check_int<UInt128>("18446744073709551616", make_u128(1, 0), OK);
+  check_int<UInt128>("12345678901234567890123456789",
+                     make_u128(669260594ULL, 5097733592125636885ULL), OK);
+  check_int<UInt128>("00000000000000000000000000000000000000000000000000001",
+                     1, OK);
+  check_int<UInt128>("340282366920938463463374607431768211455", UMax, OK);
+  check_int<UInt128>("340282366920938463463374607431768211456", UMax,
+                     IntOverflow);
+  check_int<UInt128>("3402823669209384634633746074317682114550", UMax,
+                     IntOverflow);
+  check_int<Int128>("170141183460469231731687303715884105727", IMax, OK);
+  check_int<Int128>("170141183460469231731687303715884105728", IMax,
+                    NegativeLimit);
+  check_int<Int128>("170141183460469231731687303715884105729", IMax,
+                    IntOverflow);
+
+  // Invalid characters in the first limb, in the second and after them.
+  check_int<UInt128>("12345678x", 0, NaN);
+  check_int<UInt128>("12345678901234567890123x", 0, NaN);
+  check_int<UInt128>("12345678901234567890123456789012345678x", 0, NaN);
+
+  // Bases that are powers of two.
+  check_int<UInt128>("ffffffffffffffffffffffffffffffff", UMax, OK, 16);
+  check_int<UInt128>("100000000000000000000000000000000", UMax, IntOverflow,
+                     16);
+  check_int<Int128>("80000000000000000000000000000000", IMax, NegativeLimit,
+                    16);
+  check_int<UInt128>(("1" + std::string(127, '0')).c_str(),
+                     make_u128(1ULL << 63, 0), OK, 2);
+  check_int<Int128>("f234567890abcdef1234567890abcdef",
+                    IMax, IntOverflow, 16);
+  check_int<Int128>("1234567890abcdef1234567890abcde",
+                    static_cast<Int128>(make_u128(0x1234567890abcdeULL,
+                                                  0xf1234567890abcdeULL)),
+                    OK, 16);
+
+  // Other bases.
+  check_int<UInt128>("zzzzzzzzzzzzzzzzzzzzzzzz", make_u128(
+                     0x10e425c56daffabcULL, 0x35c0ffffffffffffULL), OK, 36);
+  check_int<UInt128>("zzzzzzzzzzzzzzzzzzzzzzzzz", UMax, IntOverflow, 36);
+}
+
+
+BOOST_AUTO_TEST_CASE(Int128LimbsTest) {
+  // Numbers of all lengths around limb boundaries, compared with digit by
+  // digit accumulation.
+  const char digits[] = "9876543210123456789098765432101234567890987";
+  for (unsigned len = 1; len < sizeof(digits); ++len) {
+    UInt128 expected = 0;
+    bool overflow = false;
+    for (unsigned i = 0; i < len; ++i) {
+      UInt128 next = expected * 10 + (digits[i] - '0');
+      if (next / 10 != expected)
+        overflow = true;
+      expected = next;
+    }
+    std::string text(digits, len);
+    if (overflow)
+      check_int<UInt128>(text.c_str(), UMax, IntOverflow);
+    else
+      check_int<UInt128>(text.c_str(), expected, OK);
+  }
+}
+
+
+BOOST_AUTO_TEST_CASE(Int128ReadTest) {
+  check_read<Int128>("-12345678901234567890", -static_cast<Int128>(
+                     make_u128(0, 12345678901234567890ULL)), OK);
+  check_read<Int128>("-170141183460469231731687303715884105728", IMin, OK);
+  check_read<Int128>("-170141183460469231731687303715884105729", IMin,
+                     IntOverflowNegative);
+  check_read<Int128>("170141183460469231731687303715884105728", IMax,
+                     NegativeLimit);
+  check_read<Int128>("-0x80000000000000000000000000000000", IMin, OK);
+  check_read<UInt128>("0xffffffffffffffffffffffffffffffff", UMax, OK);
+  check_read<UInt128>("-1", 0, IntOverflowNegative);
+  check_read<UInt128>("1.5e30", make_u128(81315162936ULL,
+                                                7615416405457895424ULL),
+                      OK);
+  check_read<UInt128>("3.4028236692093846346337460743176821145e38",
+                      make_u128(0xffffffffffffffffULL, 0xfffffffffffffffaULL),
+                      OK);
+  check_read<Int128>("1.75", 1, DoubleToInt);
+  check_read<Int128>("1e39", IMax, IntOverflow);
+}
+
+
+BOOST_AUTO_TEST_CASE(Int128ConvertToTest) {
+  auto IRes = convert_to<Int128>(UMax);
+  BOOST_REQUIRE(IRes.value() == IMax);
+  BOOST_REQUIRE_EQUAL(IRes.status(), IntOverflow);
+
+  auto LRes = convert_to<long long>(IMin);
+  BOOST_REQUIRE_EQUAL(LRes.value(), std::numeric_limits<long long>::min());
+  BOOST_REQUIRE_EQUAL(LRes.status(), IntOverflowNegative);
+
+  auto URes = convert_to<UInt128>(-1);
+  BOOST_REQUIRE(URes.value() == 0);
+  BOOST_REQUIRE_EQUAL(URes.status(), IntOverflowNegative);
+
+  auto DRes = convert_to<double>(IMin);
+  BOOST_REQUIRE_EQUAL(DRes.value(), -1.7014118346046923e38);
+  BOOST_REQUIRE_EQUAL(DRes.status(), OK);
+
+  // Large values of unsigned 128-bit type exceed the range of float.
+  const UInt128 FloatMax = make_u128(0xffffff0000000000ULL, 0);
+  const UInt128 HalfUlp = make_u128(0x8000000000ULL, 0);
+  auto FRes = convert_to<float>(FloatMax + HalfUlp - 1);
+  BOOST_REQUIRE_EQUAL(FRes.value(), std::numeric_limits<float>::max());
+  BOOST_REQUIRE_EQUAL(FRes.status(), OK);
+  FRes = convert_to<float>(FloatMax + HalfUlp);
+  BOOST_REQUIRE_EQUAL(FRes.value(), std::numeric_limits<float>::max());
+  BOOST_REQUIRE_EQUAL(FRes.status(), DoubleOverflow);
+  FRes = convert_to<float>(UMax);
+  BOOST_REQUIRE_EQUAL(FRes.status(), DoubleOverflow);
+}
+
+
+BOOST_AUTO_TEST_CASE(Int128PropertyTest) {
+  BOOST_REQUIRE(extra::number_property<Int128>::lowest() == IMin);
+  BOOST_REQUIRE(extra::number_property<UInt128>::lowest() == 0);
+}
+
+#endif
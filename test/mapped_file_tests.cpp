@@ -0,0 +1,128 @@
+//===--- mapped_file_tests.cpp ----------------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///  Unit tests for reading numbers from memory mapped files.
+///
+//===----------------------------------------------------------------------===//
+
+//------ Dependencies ----------------------------------------------------------
+#include "conversion/mapped_file.h"
+#include <boost/test/unit_test.hpp>
+#include <stdio.h>
+#include <string>
+#include <vector>
+//------------------------------------------------------------------------------
+
+using namespace conversion;
+
+
+// Creates file with the specified content, removes it at destruction.
+class TempFile {
+public:
+  TempFile(const char *name, const std::string &content) : path(name) {
+    FILE *f = fopen(name, "wb");
+    BOOST_REQUIRE(f);
+    BOOST_REQUIRE_EQUAL(fwrite(content.data(), 1, content.size(), f),
+                        content.size());
+    fclose(f);
+  }
+  ~TempFile() { remove(path); }
+  const char *path;
+};
+
+
+BOOST_AUTO_TEST_CASE(MappedFileReadTest) {
+  TempFile file("mapped_file_test.txt", "12\r\n-3.5\r\nabc\r\n\r\n1e3");
+  MappedFile mapping(file.path);
+  BOOST_REQUIRE_EQUAL(mapping.error(), 0);
+  BOOST_REQUIRE(mapping.data() != nullptr);
+  BOOST_REQUIRE_EQUAL(mapping.size(), 20U);
+
+  NumberReader<double> reader(mapping);
+  std::vector<NumberRecord<double>> records;
+  NumberRecord<double> record;
+  while (reader.next(record))
+    records.push_back(record);
+  BOOST_REQUIRE_EQUAL(records.size(), 5U);
+  BOOST_REQUIRE_EQUAL(records[0].value, 12);
+  BOOST_REQUIRE_EQUAL(records[0].status, OK);
+  BOOST_REQUIRE_EQUAL(records[0].offset, 0U);
+  BOOST_REQUIRE_EQUAL(records[1].value, -3.5);
+  BOOST_REQUIRE_EQUAL(records[1].offset, 4U);
+  BOOST_REQUIRE_EQUAL(records[2].status, NaN);
+  BOOST_REQUIRE_EQUAL(records[2].offset, 10U);
+  BOOST_REQUIRE_EQUAL(records[3].status, NaN);
+  BOOST_REQUIRE_EQUAL(records[3].offset, 15U);
+
+  // The last number ends at the end of file.
+  BOOST_REQUIRE_EQUAL(records[4].value, 1000);
+  BOOST_REQUIRE_EQUAL(records[4].status, OK);
+  BOOST_REQUIRE_EQUAL(records[4].offset, 17U);
+  BOOST_REQUIRE_EQUAL(reader.offset(), mapping.size());
+  BOOST_REQUIRE(!reader.next(record));
+
+  // Mapping can be moved.
+  MappedFile other(std::move(mapping));
+  BOOST_REQUIRE(mapping.data() == nullptr);
+  BOOST_REQUIRE_EQUAL(other.size(), 20U);
+  other.close();
+  BOOST_REQUIRE_EQUAL(other.size(), 0U);
+}
+
+
+BOOST_AUTO_TEST_CASE(MappedFileTruncatedNumberTest) {
+  // Number is cut by the end of file in the middle of exponent.
+  TempFile file("mapped_file_test.txt", "7,1e+");
+  MappedFile mapping;
+  BOOST_REQUIRE(mapping.open(file.path));
+  NumberReader<int> reader(mapping, ',');
+  NumberRecord<int> record;
+  BOOST_REQUIRE(reader.next(record));
+  BOOST_REQUIRE_EQUAL(record.value, 7);
+  BOOST_REQUIRE(reader.next(record));
+  BOOST_REQUIRE_EQUAL(record.status, NaN);
+  BOOST_REQUIRE_EQUAL(record.offset, 2U);
+  BOOST_REQUIRE(!reader.next(record));
+}
+
+
+BOOST_AUTO_TEST_CASE(MappedFileEmptyTest) {
+  TempFile file("mapped_file_test.txt", "");
+  MappedFile mapping;
+  BOOST_REQUIRE(mapping.open(file.path));
+  BOOST_REQUIRE_EQUAL(mapping.size(), 0U);
+  NumberReader<long> reader(mapping);
+  NumberRecord<long> record;
+  BOOST_REQUIRE(!reader.next(record));
+
+  BOOST_REQUIRE(!mapping.open("no/such/file.txt"));
+  BOOST_REQUIRE(mapping.error() != 0);
+  BOOST_REQUIRE(mapping.data() == nullptr);
+}
@@ -0,0 +1,354 @@
+//===--- number_formatter_tests.cpp -----------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///  Unit tests for conversion of numbers to text.
+///
+//===----------------------------------------------------------------------===//
+
+//------ Dependencies ----------------------------------------------------------
+#include "conversion/number_formatter.h"
+#include <boost/test/unit_test.hpp>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+//------------------------------------------------------------------------------
+
+using namespace conversion;
+
+
+template<typename IntType>
+static std::string format(IntType value, unsigned base = 10,
+                          unsigned flags = DefaultFormat) {
+  char buf[MaxIntTextLength];
+  unsigned len = format_int(buf, MaxIntTextLength, value, base, flags);
+  return std::string(buf, len);
+}
+
+
+BOOST_AUTO_TEST_CASE(FormatIntDecimalTest) {
+  BOOST_REQUIRE_EQUAL(format(0), "0");
+  BOOST_REQUIRE_EQUAL(format(7), "7");
+  BOOST_REQUIRE_EQUAL(format(10), "10");
+  BOOST_REQUIRE_EQUAL(format(99), "99");
+  BOOST_REQUIRE_EQUAL(format(100), "100");
+  BOOST_REQUIRE_EQUAL(format(-1), "-1");
+  BOOST_REQUIRE_EQUAL(format(-120), "-120");
+  BOOST_REQUIRE_EQUAL(format(12345, 10, FormatPlus), "+12345");
+  BOOST_REQUIRE_EQUAL(format(std::numeric_limits<signed char>::min()), "-128");
+  BOOST_REQUIRE_EQUAL(format(std::numeric_limits<unsigned char>::max()),
+                      "255");
+  BOOST_REQUIRE_EQUAL(format(std::numeric_limits<int>::min()), "-2147483648");
+  BOOST_REQUIRE_EQUAL(format(std::numeric_limits<long long>::min()),
+                      "-9223372036854775808");
+  BOOST_REQUIRE_EQUAL(format(std::numeric_limits<unsigned long long>::max()),
+                      "18446744073709551615");
+
+  // Compare with snprintf on values of various magnitudes.
+  for (uint64_t x = 1; x != 0; x = x * 3 + 1) {
+    char expected[32];
+    snprintf(expected, sizeof(expected), "%" PRIu64, x);
+    BOOST_REQUIRE_EQUAL(format(x), expected);
+    int64_t y = -static_cast<int64_t>(x >> 1);
+    snprintf(expected, sizeof(expected), "%" PRId64, y);
+    BOOST_REQUIRE_EQUAL(format(y), expected);
+    if (x > UINT64_MAX / 4)
+      break;
+  }
+}
+
+
+BOOST_AUTO_TEST_CASE(FormatIntBaseTest) {
+  BOOST_REQUIRE_EQUAL(format(255, 16), "ff");
+  BOOST_REQUIRE_EQUAL(format(255, 16, FormatUpper), "FF");
+  BOOST_REQUIRE_EQUAL(format(255, 16, FormatPrefix), "0xff");
+  BOOST_REQUIRE_EQUAL(format(255, 16, FormatPrefix | FormatUpper), "0XFF");
+  BOOST_REQUIRE_EQUAL(format(-255, 16, FormatPrefix), "-0xff");
+  BOOST_REQUIRE_EQUAL(format(8, 8, FormatPrefix), "0o10");
+  BOOST_REQUIRE_EQUAL(format(5, 2, FormatPrefix), "0b101");
+  BOOST_REQUIRE_EQUAL(format(0, 2), "0");
+  BOOST_REQUIRE_EQUAL(format(35, 36), "z");
+  BOOST_REQUIRE_EQUAL(format(36, 36, FormatPrefix), "10");
+  BOOST_REQUIRE_EQUAL(format(-100, 3), "-10201");
+  BOOST_REQUIRE_EQUAL(format(std::numeric_limits<long long>::min(), 2),
+                      "-1" + std::string(63, '0'));
+  BOOST_REQUIRE_EQUAL(format(std::numeric_limits<uint64_t>::max(), 2,
+                             FormatPrefix), "0b" + std::string(64, '1'));
+  BOOST_REQUIRE_EQUAL(format(std::numeric_limits<uint64_t>::max(), 16),
+                      "ffffffffffffffff");
+  BOOST_REQUIRE_EQUAL(format(std::numeric_limits<uint64_t>::max(), 8),
+                      "1777777777777777777777");
+  BOOST_REQUIRE_EQUAL(format(01234567, 32), "aebn");
+
+  // Output is converted back.
+  for (unsigned base = MinBase; base <= MaxBase; ++base) {
+    for (uint64_t x = 0; x < 2000003; x += 9973) {
+      char buf[MaxIntTextLength];
+      unsigned len = format_int(buf, MaxIntTextLength, x, base);
+      uint64_t value;
+      BOOST_REQUIRE_EQUAL(convert_int(value, buf, len, base), OK);
+      BOOST_REQUIRE_EQUAL(value, x);
+    }
+  }
+}
+
+
+BOOST_AUTO_TEST_CASE(FormatIntBufferTest) {
+  char buf[4] = { 'a', 'a', 'a', 'a' };
+  BOOST_REQUIRE_EQUAL(format_int(buf, 4, 1234), 4);
+  BOOST_REQUIRE(std::string(buf, 4) == "1234");
+  BOOST_REQUIRE_EQUAL(format_int(buf, 4, 12345), 0);
+  BOOST_REQUIRE_EQUAL(format_int(buf, 4, -123), 4);
+  BOOST_REQUIRE_EQUAL(format_int(buf, 3, -123), 0);
+  BOOST_REQUIRE_EQUAL(format_int(buf, 4, 12, 1), 0);
+  BOOST_REQUIRE_EQUAL(format_int(buf, 4, 12, 37), 0);
+
+  wchar_t wbuf[MaxIntTextLength];
+  unsigned len = format_int(wbuf, MaxIntTextLength, -0xABCL, 16,
+                            FormatPrefix | FormatUpper);
+  BOOST_REQUIRE(std::wstring(wbuf, len) == L"-0XABC");
+}
+
+
+template<typename FloatT>
+static std::string format(FloatT value, FloatNotation notation,
+                          unsigned flags = DefaultFormat) {
+  char buf[MaxFloatTextLength];
+  unsigned len = format_float(buf, MaxFloatTextLength, value, notation, flags);
+  return std::string(buf, len);
+}
+
+
+BOOST_AUTO_TEST_CASE(FormatFloatTest) {
+  BOOST_REQUIRE_EQUAL(format(0.0, GeneralNotation), "0");
+  BOOST_REQUIRE_EQUAL(format(-0.0, GeneralNotation), "-0");
+  BOOST_REQUIRE_EQUAL(format(0.0, ScientificNotation), "0e0");
+  BOOST_REQUIRE_EQUAL(format(1.0, GeneralNotation), "1");
+  BOOST_REQUIRE_EQUAL(format(0.1, GeneralNotation), "0.1");
+  BOOST_REQUIRE_EQUAL(format(0.3, GeneralNotation), "0.3");
+  BOOST_REQUIRE_EQUAL(format(0.1 + 0.2, GeneralNotation),
+                      "0.30000000000000004");
+  BOOST_REQUIRE_EQUAL(format(-1.5, GeneralNotation, FormatPlus), "-1.5");
+  BOOST_REQUIRE_EQUAL(format(1.5, GeneralNotation, FormatPlus), "+1.5");
+  BOOST_REQUIRE_EQUAL(format(123.456, GeneralNotation), "123.456");
+  BOOST_REQUIRE_EQUAL(format(123.456, ScientificNotation), "1.23456e2");
+  BOOST_REQUIRE_EQUAL(format(123.456, FixedNotation), "123.456");
+  BOOST_REQUIRE_EQUAL(format(1e-4, GeneralNotation), "0.0001");
+  BOOST_REQUIRE_EQUAL(format(1.5e-5, GeneralNotation), "1.5e-5");
+  BOOST_REQUIRE_EQUAL(format(1.5e-5, GeneralNotation, FormatUpper), "1.5E-5");
+  BOOST_REQUIRE_EQUAL(format(1.5e-5, FixedNotation), "0.000015");
+  BOOST_REQUIRE_EQUAL(format(1e16, GeneralNotation), "10000000000000000");
+  BOOST_REQUIRE_EQUAL(format(1e17, GeneralNotation), "1e17");
+  BOOST_REQUIRE_EQUAL(format(1e23, GeneralNotation), "1e23");
+  BOOST_REQUIRE_EQUAL(format(1e23, FixedNotation),
+                      "100000000000000000000000");
+  BOOST_REQUIRE_EQUAL(format(9007199254740993.0, GeneralNotation),
+                      "9007199254740992");
+  BOOST_REQUIRE_EQUAL(format(5e-324, GeneralNotation), "5e-324");
+  BOOST_REQUIRE_EQUAL(format(-5e-324, FixedNotation),
+                      "-0." + std::string(323, '0') + "5");
+  BOOST_REQUIRE_EQUAL(format(-5e-324, FixedNotation).size(),
+                      MaxFloatTextLength);
+  BOOST_REQUIRE_EQUAL(format(1.7976931348623157e308, GeneralNotation),
+                      "1.7976931348623157e308");
+  BOOST_REQUIRE_EQUAL(format(2.2250738585072014e-308, GeneralNotation),
+                      "2.2250738585072014e-308");
+  BOOST_REQUIRE_EQUAL(format(std::numeric_limits<double>::infinity(),
+                             GeneralNotation), "inf");
+  BOOST_REQUIRE_EQUAL(format(-std::numeric_limits<double>::infinity(),
+                             GeneralNotation, FormatUpper), "-INF");
+  BOOST_REQUIRE_EQUAL(format(std::numeric_limits<double>::quiet_NaN(),
+                             GeneralNotation), "nan");
+
+  BOOST_REQUIRE_EQUAL(format(0.1f, GeneralNotation), "0.1");
+  BOOST_REQUIRE_EQUAL(format(1.0f / 3, GeneralNotation), "0.33333334");
+  BOOST_REQUIRE_EQUAL(format(16777216.0f, GeneralNotation), "16777216");
+  BOOST_REQUIRE_EQUAL(format(1e10f, GeneralNotation), "1e10");
+  BOOST_REQUIRE_EQUAL(format(3.4028235e38f, GeneralNotation), "3.4028235e38");
+  BOOST_REQUIRE_EQUAL(format(1e-45f, GeneralNotation), "1e-45");
+
+  char buf[4];
+  BOOST_REQUIRE_EQUAL(format_float(buf, 4, 1.25), 4);
+  BOOST_REQUIRE_EQUAL(format_float(buf, 4, 1.125), 0);
+
+  wchar_t wbuf[32];
+  unsigned len = format_float(wbuf, 32, -2.5e-10, ScientificNotation);
+  BOOST_REQUIRE(std::wstring(wbuf, len) == L"-2.5e-10");
+}
+
+
+// Checks the output for the value against printf and conversion back.
+template<typename FloatT>
+static void check_shortest(FloatT value) {
+  std::string text = format(value, ScientificNotation);
+
+  // The text must be converted back to the same value.
+  NumberRecognizer<> recog(text.c_str(), text.size());
+  FloatT parsed;
+  recog.recognize().read(parsed);
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE(recog.success());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(parsed, value);
+
+  // The shortest correctly rounded printf output that converts back must have
+  // the same number of digits. If the result of printf is the same length, it
+  // is closest to the value and must coincide with ours.
+  unsigned digits = 0;
+  for (size_t i = 0; i < text.find('e'); ++i)
+    digits += isdigit(text[i]) ? 1 : 0;
+  char expected[40];
+  for (int precision = 1; precision <= 17; ++precision) {
+    snprintf(expected, sizeof(expected), "%.*e", precision - 1,
+             static_cast<double>(value));
+    if (static_cast<FloatT>(strtod(expected, nullptr)) == value) {
+      BOOST_TEST_INFO(text << " vs " << expected);
+      BOOST_REQUIRE_LE(digits, static_cast<unsigned>(precision));
+      if (digits == static_cast<unsigned>(precision)) {
+        double expected_value = strtod(expected, nullptr);
+        BOOST_TEST_INFO(text << " vs " << expected);
+        BOOST_REQUIRE_EQUAL(strtod(text.c_str(), nullptr), expected_value);
+      }
+      break;
+    }
+  }
+}
+
+
+BOOST_AUTO_TEST_CASE(FormatFloatShortestTest) {
+  uint64_t state = 0x123456789ABCDEFULL;
+  for (unsigned i = 0; i < 100000; ++i) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    uint64_t bits = state ^ (state >> 29);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    if (std::isfinite(value) && value != 0)
+      check_shortest(value);
+    uint32_t fbits = static_cast<uint32_t>(bits >> 32);
+    float fvalue;
+    memcpy(&fvalue, &fbits, sizeof(fvalue));
+    if (std::isfinite(fvalue) && fvalue != 0)
+      check_shortest(fvalue);
+  }
+
+  // Powers of two have asymmetric rounding interval.
+  for (int e = -1074; e <= 1023; ++e)
+    check_shortest(std::ldexp(1.0, e));
+  for (int e = -149; e <= 127; ++e)
+    check_shortest(std::ldexp(1.0f, e));
+
+  // Numbers with few digits.
+  for (int e = -300; e <= 300; e += 7)
+    for (int m = 1; m < 1000; m += 37)
+      check_shortest(m * std::pow(10.0, e));
+}
+
+
+template<typename IntType>
+static void check_lengths(IntType value) {
+  for (unsigned base = MinBase; base <= MaxBase; ++base) {
+    for (unsigned flags = 0; flags <= (FormatPrefix | FormatPlus); ++flags) {
+      char buf[MaxIntTextLength];
+      unsigned len = format_int(buf, MaxIntTextLength, value, base, flags);
+      BOOST_REQUIRE_EQUAL(formatted_length(value, base, flags), len);
+      BOOST_REQUIRE_LE(len, max_formatted_length<IntType>(base));
+    }
+  }
+}
+
+
+BOOST_AUTO_TEST_CASE(FormattedLengthTest) {
+  static_assert(max_formatted_length<uint64_t>(2) == MaxIntTextLength,
+                "wrong bound");
+  static_assert(max_formatted_length<int>() == 10 + 3, "wrong bound");
+  static_assert(max_formatted_length<unsigned char>(16) == 2 + 3,
+                "wrong bound");
+  BOOST_REQUIRE_EQUAL(formatted_length(0), 1);
+  BOOST_REQUIRE_EQUAL(formatted_length(9), 1);
+  BOOST_REQUIRE_EQUAL(formatted_length(10), 2);
+  BOOST_REQUIRE_EQUAL(formatted_length(-10), 3);
+  BOOST_REQUIRE_EQUAL(formatted_length(10, 10, FormatPlus), 3);
+  BOOST_REQUIRE_EQUAL(formatted_length(255, 16, FormatPrefix), 4);
+  BOOST_REQUIRE_EQUAL(formatted_length(255, 10, FormatPrefix), 3);
+  BOOST_REQUIRE_EQUAL(formatted_length(1, 1), 0);
+
+  // Every power of ten and its neighbors, in all integer types.
+  uint64_t power = 1;
+  for (unsigned i = 0; i < 20; ++i, power *= 10) {
+    for (uint64_t x = power - 1; x <= power + 1; ++x) {
+      check_lengths(x);
+      check_lengths(static_cast<int64_t>(x));
+      check_lengths(static_cast<int64_t>(0 - x));
+      check_lengths(static_cast<uint32_t>(x));
+      check_lengths(static_cast<int32_t>(x));
+      check_lengths(static_cast<unsigned short>(x));
+      check_lengths(static_cast<short>(x));
+      check_lengths(static_cast<unsigned char>(x));
+      check_lengths(static_cast<signed char>(x));
+      check_lengths(static_cast<char>(x));
+      check_lengths(static_cast<long>(x));
+      check_lengths(static_cast<unsigned long>(x));
+    }
+  }
+  for (unsigned bits = 0; bits < 64; ++bits) {
+    uint64_t x = uint64_t(1) << bits;
+    check_lengths(x - 1);
+    check_lengths(x);
+  }
+}
+
+
+BOOST_AUTO_TEST_CASE(FormatBatchTest) {
+  const int values[] = { 12, -7, 0, 2147483647, -2147483647 - 1 };
+  const size_t count = sizeof(values) / sizeof(values[0]);
+  const std::string expected = "12,-7,0,2147483647,-2147483648";
+
+  BOOST_REQUIRE_EQUAL(batch_length(values, count), expected.size());
+  char buf[64];
+  BOOST_REQUIRE_EQUAL(format_batch(buf, sizeof(buf), values, count, ','),
+                      expected.size());
+  BOOST_REQUIRE_EQUAL(std::string(buf, expected.size()), expected);
+  BOOST_REQUIRE_EQUAL(format_batch(buf, expected.size() - 1, values, count,
+                                   ','), 0);
+
+  std::string out = "x=";
+  BOOST_REQUIRE_EQUAL(format_batch(out, values, count, ';'), expected.size());
+  BOOST_REQUIRE_EQUAL(out, "x=12;-7;0;2147483647;-2147483648");
+
+  const uint8_t bytes[] = { 0, 15, 255 };
+  std::wstring wout;
+  format_batch(wout, bytes, 3, L' ', 16, FormatPrefix | FormatUpper);
+  BOOST_REQUIRE(wout == L"0X0 0XF 0XFF");
+
+  BOOST_REQUIRE_EQUAL(batch_length(values, 0), 0);
+  BOOST_REQUIRE_EQUAL(format_batch(out, values, 0, ','), 0);
+}
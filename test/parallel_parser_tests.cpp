@@ -0,0 +1,130 @@
+//===--- parallel_parser_tests.cpp ------------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///  Unit tests for parallel conversion of delimited buffers.
+///
+//===----------------------------------------------------------------------===//
+
+//------ Dependencies ----------------------------------------------------------
+#include "conversion/parallel_parser.h"
+#include <boost/test/unit_test.hpp>
+#include <string>
+#include <vector>
+//------------------------------------------------------------------------------
+
+using namespace conversion;
+
+
+// Builds buffer of numbers separated by delimiter, some of the fields are
+// invalid.
+static std::string make_buffer(unsigned count, char delim,
+                               std::vector<unsigned> &bad_fields) {
+  std::string buf;
+  unsigned seed = 1;
+  for (unsigned i = 0; i < count; ++i) {
+    seed = seed * 1103515245 + 12345;
+    if (seed % 97 == 0) {
+      buf += "bad";
+      bad_fields.push_back(i);
+    } else {
+      buf += std::to_string(long(seed >> 4) - 100000000L);
+    }
+    buf += delim;
+  }
+  return buf;
+}
+
+
+BOOST_AUTO_TEST_CASE(ParallelMatchesSequentialTest) {
+  std::vector<unsigned> bad_fields;
+  std::string buf = make_buffer(20000, '\n', bad_fields);
+  size_t count = count_fields(buf.data(), buf.size(), '\n');
+  BOOST_REQUIRE_EQUAL(count, 20000U);
+
+  std::vector<long> expected(count);
+  std::vector<Status> expected_st(count);
+  BOOST_REQUIRE_EQUAL(parse_delimited(buf.data(), buf.size(), '\n',
+                                      expected.data(), expected_st.data(),
+                                      count), count);
+
+  for (unsigned threads : { 1U, 2U, 3U, 8U }) {
+    for (size_t chunk_size : { size_t(1), size_t(100), size_t(4096),
+                               DefaultChunkSize }) {
+      std::vector<long> values(count, -1);
+      std::vector<Status> statuses(count, NaN);
+      std::vector<ChunkResult> chunks = parse_delimited_parallel(
+        buf.data(), buf.size(), '\n', values.data(), statuses.data(), count,
+        threads, DefaultOptions, chunk_size);
+      BOOST_REQUIRE(values == expected);
+      BOOST_REQUIRE(statuses == expected_st);
+
+      // Chunks cover the buffer and all fields, errors are reported.
+      size_t pos = 0, fields = 0, errors = 0;
+      for (const ChunkResult &chunk : chunks) {
+        BOOST_REQUIRE_EQUAL(chunk.begin, pos);
+        BOOST_REQUIRE_EQUAL(chunk.first_field, fields);
+        BOOST_REQUIRE_EQUAL(buf[chunk.end - 1], '\n');
+        if (chunk.error_count) {
+          BOOST_REQUIRE_EQUAL(chunk.first_error, bad_fields[errors]);
+        } else {
+          BOOST_REQUIRE_EQUAL(chunk.first_error,
+                              chunk.first_field + chunk.field_count);
+        }
+        pos = chunk.end;
+        fields += chunk.field_count;
+        errors += chunk.error_count;
+      }
+      BOOST_REQUIRE_EQUAL(pos, buf.size());
+      BOOST_REQUIRE_EQUAL(fields, count);
+      BOOST_REQUIRE_EQUAL(errors, bad_fields.size());
+    }
+  }
+}
+
+
+BOOST_AUTO_TEST_CASE(ParallelLimitsTest) {
+  std::string buf = "1.5,2.5,x,4.5";
+  double values[3];
+  std::vector<ChunkResult> chunks = parse_delimited_parallel(
+    buf.data(), buf.size(), ',', values, nullptr, 3, 2, DefaultOptions, 2);
+  size_t fields = 0, errors = 0;
+  for (const ChunkResult &chunk : chunks) {
+    fields += chunk.field_count;
+    errors += chunk.error_count;
+  }
+  BOOST_REQUIRE_EQUAL(fields, 3U);
+  BOOST_REQUIRE_EQUAL(errors, 1U);
+  BOOST_REQUIRE_EQUAL(values[0], 1.5);
+  BOOST_REQUIRE_EQUAL(values[1], 2.5);
+
+  // Empty buffer.
+  chunks = parse_delimited_parallel(buf.data(), 0, ',', values, nullptr, 3);
+  BOOST_REQUIRE(chunks.empty());
+}
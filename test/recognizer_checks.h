@@ -0,0 +1,132 @@
+//===--- recognizer_checks.h ------------------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///  Helpers shared by tests that compare recognizer states.
+///
+//===----------------------------------------------------------------------===//
+#ifndef CONVERSION_TEST_RECOGNIZER_CHECKS_H_
+#define CONVERSION_TEST_RECOGNIZER_CHECKS_H_
+
+//------ Dependencies ----------------------------------------------------------
+#include "conversion/number_recognizer.h"
+#include <boost/test/unit_test.hpp>
+#include <string>
+//------------------------------------------------------------------------------
+
+namespace conversion {
+namespace test {
+
+/// Texts recognized by different ways in tests of recognizer states.
+static const char *RecognizerTestStrings[] = {
+  "", " ", "  ", "+", "-", " - ", "0", "-0", "00", "000", "+12", "  123  ",
+  "0x1F", "0X", "0x", "0xg", "0x0", "0x00f", "-0x00f", "0b101", "0b2", "0o17",
+  "0q17", "0o8", "017", "019", "00012", "0012a", "0a", "1.5", ".5", "5.", ".",
+  "-.", "0.0", ".000", "0.000", "1.2500", "-1.25e3", "1e", "1E5", "1e+", "1e-",
+  "1e+x", "1ex", "2e-3x", "1e0", "1e00", "1e007", "1e00x", "1e0 ", "1e10 ",
+  "1.5 abc", "0x1.8p3", "ffff", "abc", "0xffffffff", "18446744073709551616",
+  "-9223372036854775808", "  +0b1111 ", "12abc", "1 2", "7e99999999999",
+  "1e-99999999999", "123.456e-2", "0.00000000000000000000000001e26",
+  "4.9406564584124654e-324", "1.7976931348623157e308", "1.8e308",
+  "2.2250738585072011e-308", "0.1e1", "100e-2", "100.e-2", "1234567e-3",
+  "-1.2300e-0045  ;", "\t\t0.00012e+12\t"
+};
+
+
+/// \brief Checks that the state reports the same number parts as the
+/// recognizer that got the whole text.
+///
+/// Leading zeros of mantissa are compared only for numbers with exponent, as
+/// the stream recognizer does not keep them otherwise.
+///
+template<typename StateT>
+void compare_parts(const std::string &text,
+                   const NumberRecognizerState &expected,
+                   const StateT &state) {
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.success(), expected.success());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.partial(), expected.partial());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.failure(), expected.failure());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.get_base(), expected.get_base());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.is_float(), expected.is_float());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.has_minus(), expected.has_minus());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.has_exp_minus(), expected.has_exp_minus());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.get_prefix_length(),
+                      expected.get_prefix_length());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.get_leading_ws(), expected.get_leading_ws());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.get_int_start(), expected.get_int_start());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.get_int_length(), expected.get_int_length());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.get_frac_start(), expected.get_frac_start());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.get_frac_length(), expected.get_frac_length());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.get_exp_start(), expected.get_exp_start());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.get_exp_length(), expected.get_exp_length());
+  if (expected.get_exp_length()) {
+    BOOST_TEST_INFO(text);
+    BOOST_REQUIRE_EQUAL(state.get_leading_zeros(),
+                        expected.get_leading_zeros());
+  }
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.get_trailing_ws(), expected.get_trailing_ws());
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(state.get_rest_start(), expected.get_rest_start());
+}
+
+
+/// \brief Checks that both recognizers convert the number into the same
+/// value with the same status.
+///
+template<typename NumType, typename RecognizerT, typename OtherT>
+void compare_values(const std::string &text, RecognizerT &expected,
+                    OtherT &recog) {
+  NumType expected_value, value;
+  Status expected_st = expected.read(expected_value);
+  Status st = recog.read(value);
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(st, expected_st);
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(value, expected_value);
+}
+
+}
+}
+#endif
@@ -0,0 +1,188 @@
+//===--- recognizer_fixed_tests.cpp -----------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Unit tests for reading numbers as fixed point values.
+///
+//===----------------------------------------------------------------------===//
+
+//------ Dependencies ----------------------------------------------------------
+#include "conversion/number_recognizer.h"
+#include <boost/test/unit_test.hpp>
+#include <string>
+//------------------------------------------------------------------------------
+
+using namespace conversion;
+
+
+template<typename IntType, unsigned Scale>
+static void check_fixed(const char *text, IntType expected,
+                        Status expected_status,
+                        RoundingMode mode = RoundHalfEven,
+                        unsigned options = DefaultOptions) {
+  NumberRecognizer<> Recog(options);
+  Recog.recognize(text);
+  IntType value;
+  Status status = Recog.read_fixed<IntType, Scale>(value, mode);
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(value, expected);
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(status, expected_status);
+  BOOST_REQUIRE_EQUAL(Recog.get_status(), expected_status);
+}
+
+
+BOOST_AUTO_TEST_CASE(FixedExactTest) {
+  check_fixed<long long, 8>("123.45678901", 12345678901LL, OK);
+  check_fixed<long long, 8>("-0.00000001", -1, OK);
+  check_fixed<long long, 8>("42", 4200000000LL, OK);
+  check_fixed<long long, 8>("  7.5  ", 750000000, OK);
+  check_fixed<long long, 8>("0.0", 0, OK);
+  check_fixed<long long, 8>("-0", 0, OK);
+  check_fixed<long long, 8>("1.2300000000000000000", 123000000, OK);
+  check_fixed<long long, 2>("1.5e3", 150000, OK);
+  check_fixed<long long, 2>("125e-2", 125, OK);
+  check_fixed<long long, 2>("0.0000125e5", 125, OK);
+  check_fixed<long long, 0>("12", 12, OK);
+  check_fixed<int, 4>("0.1", 1000, OK);
+  check_fixed<unsigned, 3>("4294967.295", 4294967295U, OK);
+
+  // Digits beyond precision of double are kept.
+  check_fixed<long long, 8>("92233720368.54775807",
+                            std::numeric_limits<long long>::max(), OK);
+  check_fixed<long long, 8>("-92233720368.54775808",
+                            std::numeric_limits<long long>::min(), OK);
+
+  // Integers in other bases are scaled.
+  check_fixed<int, 2>("0x10", 1600, OK, RoundHalfEven,
+                      Floating | Prefix0x);
+  check_fixed<int, 2>("-0b101", -500, OK, RoundHalfEven,
+                      Floating | Prefix0b);
+}
+
+
+BOOST_AUTO_TEST_CASE(FixedRoundingTest) {
+  static const char *const texts[] = {
+    "1.234", "1.235", "1.2350", "1.2351", "1.245", "1.239",
+    "-1.234", "-1.235", "-1.245", "-1.2351", "0.005", "-0.001", "0.00001e2"
+  };
+  static const int expected[][5] = {
+    // HalfEven, HalfAway, TowardZero, Floor, Ceiling
+    {  123,  123,  123,  123,  124 },
+    {  124,  124,  123,  123,  124 },
+    {  124,  124,  123,  123,  124 },
+    {  124,  124,  123,  123,  124 },
+    {  124,  125,  124,  124,  125 },
+    {  124,  124,  123,  123,  124 },
+    { -123, -123, -123, -124, -123 },
+    { -124, -124, -123, -124, -123 },
+    { -124, -125, -124, -125, -124 },
+    { -124, -124, -123, -124, -123 },
+    {    0,    1,    0,    0,    1 },
+    {    0,    0,    0,   -1,    0 },
+    {    0,    0,    0,    0,    1 }
+  };
+  static const RoundingMode modes[] = {
+    RoundHalfEven, RoundHalfAway, RoundTowardZero, RoundFloor, RoundCeiling
+  };
+  for (unsigned i = 0; i < sizeof(texts) / sizeof(texts[0]); ++i)
+    for (unsigned m = 0; m < 5; ++m)
+      check_fixed<int, 2>(texts[i], expected[i][m], DoubleToInt, modes[m]);
+
+  // Digits far beyond the scale.
+  check_fixed<int, 2>("0.00500000000000000000000000001", 1, DoubleToInt);
+  check_fixed<int, 2>("0.00500000000000000000000000000", 0, DoubleToInt);
+  check_fixed<int, 2>("1e-100", 0, DoubleToInt, RoundHalfAway);
+  check_fixed<int, 2>("1e-100", 1, DoubleToInt, RoundCeiling);
+  check_fixed<unsigned, 2>("-1e-100", 0, DoubleToInt, RoundCeiling);
+  check_fixed<unsigned, 2>("-1e-100", 0, IntOverflowNegative, RoundFloor);
+}
+
+
+BOOST_AUTO_TEST_CASE(FixedOverflowTest) {
+  typedef std::numeric_limits<long long> LLimits;
+  typedef std::numeric_limits<short> SLimits;
+
+  check_fixed<long long, 8>("92233720368.54775808", LLimits::max(),
+                            IntOverflow);
+  check_fixed<long long, 8>("-92233720368.54775808", LLimits::min(), OK);
+  check_fixed<long long, 8>("92233720368.54775809", LLimits::max(),
+                            IntOverflow);
+  check_fixed<long long, 8>("-92233720368.54775809", LLimits::min(),
+                            IntOverflowNegative);
+  check_fixed<long long, 8>("1e100", LLimits::max(), IntOverflow);
+  check_fixed<long long, 8>("-1e100000000000", LLimits::min(),
+                            IntOverflowNegative);
+
+  // Rounding may produce the limit or overflow.
+  check_fixed<short, 1>("3276.7", SLimits::max(), OK);
+  check_fixed<short, 1>("-3276.75", SLimits::min(), DoubleToInt);
+  check_fixed<short, 1>("-3276.85", SLimits::min(), DoubleToInt);
+  check_fixed<short, 1>("-3276.81", SLimits::min(), DoubleToInt);
+  check_fixed<short, 1>("-3276.86", SLimits::min(), IntOverflowNegative);
+  check_fixed<short, 1>("3276.74", SLimits::max(), DoubleToInt);
+  check_fixed<short, 1>("3276.75", SLimits::max(), IntOverflow);
+  check_fixed<int, 0>("2147483647.5", std::numeric_limits<int>::max(),
+                      IntOverflow);
+  check_fixed<int, 0>("2147483647.5", std::numeric_limits<int>::max(),
+                      DoubleToInt, RoundFloor);
+  check_fixed<int, 0>("-2147483648.5", std::numeric_limits<int>::min(),
+                      IntOverflowNegative, RoundHalfAway);
+  check_fixed<long long, 2>("92233720368547758.075", LLimits::max(),
+                            IntOverflow, RoundHalfAway);
+  check_fixed<long long, 2>("-92233720368547758.075", LLimits::min(),
+                            DoubleToInt, RoundHalfAway);
+  check_fixed<unsigned short, 1>("6553.55", 65535, IntOverflow);
+  check_fixed<unsigned short, 1>("6553.55", 65535, DoubleToInt,
+                                 RoundTowardZero);
+  check_fixed<int, 2>("0x7fffffff", std::numeric_limits<int>::max(),
+                      IntOverflow, RoundHalfEven, Floating | Prefix0x);
+  check_fixed<int, 0>("-0x80000000", std::numeric_limits<int>::min(), OK,
+                      RoundHalfEven, Floating | Prefix0x);
+  check_fixed<int, 0>("0x80000000", std::numeric_limits<int>::max(),
+                      IntOverflow, RoundHalfEven, Floating | Prefix0x);
+  check_fixed<int, 1>("-0x80000000", std::numeric_limits<int>::min(),
+                      IntOverflowNegative, RoundHalfEven, Floating | Prefix0x);
+  check_fixed<int, 2>("-0x80000000", std::numeric_limits<int>::min(),
+                      IntOverflowNegative, RoundHalfEven, Floating | Prefix0x);
+}
+
+
+BOOST_AUTO_TEST_CASE(FixedErrorTest) {
+  check_fixed<int, 2>("", 0, NaN);
+  check_fixed<int, 2>("abc", 0, NaN);
+  check_fixed<int, 2>("0x1.8p1", 0, NaN, RoundHalfEven,
+                      Floating | Prefix0x | HexFloating);
+
+  NumberRecognizer<> Recog("12.5abc");
+  int value = Recog.to_fixed<int, 1>();
+  BOOST_REQUIRE_EQUAL(value, 125);
+  BOOST_REQUIRE(Recog.partial());
+  BOOST_REQUIRE_EQUAL(Recog.get_status(), OK);
+}
@@ -35,6 +35,7 @@
 //------ Dependencies ----------------------------------------------------------
 #include "conversion/number_recognizer.h"
 #include <boost/test/unit_test.hpp>
+#include <cmath>
 #include <memory>
 //------------------------------------------------------------------------------
 
@@ -722,3 +723,232 @@ BOOST_AUTO_TEST_CASE(FloatTest12) {
   BOOST_REQUIRE(Recog.to<double>() == -12345670000);
   BOOST_REQUIRE(Recog.get_status() == OK);
 }
+
+
+template<typename NumType>
+static void check_float_to_int(const char *text, NumType expected,
+                               Status expected_status) {
+  NumberRecognizer<> Recog(text);
+  NumType value;
+  Status status = Recog.read(value);
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(value, expected);
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(status, expected_status);
+  BOOST_REQUIRE_EQUAL(Recog.get_status(), expected_status);
+}
+
+
+BOOST_AUTO_TEST_CASE(FloatToIntTest) {
+  typedef std::numeric_limits<long long> LLimits;
+  typedef std::numeric_limits<unsigned long long> ULimits;
+
+  check_float_to_int<int>("1.5e3", 1500, OK);
+  check_float_to_int<int>("12345.000", 12345, OK);
+  check_float_to_int<int>("1500e-2", 15, OK);
+  check_float_to_int<int>("0.0e5", 0, OK);
+  check_float_to_int<int>("-0.0", 0, OK);
+  check_float_to_int<int>("000.00120e4", 12, OK);
+  check_float_to_int<int>("123.456e1", 1234, DoubleToInt);
+  check_float_to_int<int>("-123.456e1", -1234, DoubleToInt);
+  check_float_to_int<int>("1e-5", 0, DoubleToInt);
+  check_float_to_int<int>("-0.5", 0, DoubleToInt);
+  check_float_to_int<unsigned>("-0.5", 0, DoubleToInt);
+  check_float_to_int<unsigned>("-1.5", 0, IntOverflowNegative);
+
+  // Values above 2^53 are exact.
+  check_float_to_int<long long>("9.223372036854775807e18", LLimits::max(), OK);
+  check_float_to_int<long long>("-9.223372036854775808e18", LLimits::min(),
+                                OK);
+  check_float_to_int<long long>("-922337203685477580.85e1", LLimits::min(),
+                                DoubleToInt);
+  check_float_to_int<long long>("9.223372036854775808e18", LLimits::max(),
+                                NegativeLimit);
+  check_float_to_int<long long>("12345678901234567.89e2",
+                                1234567890123456789LL, OK);
+  check_float_to_int<long long>("1234567890123456.789e3",
+                                1234567890123456789LL, OK);
+  check_float_to_int<long long>("9007199254740993.0", 9007199254740993LL, OK);
+  check_float_to_int<unsigned long long>("1.8446744073709551615e19",
+                                         ULimits::max(), OK);
+  check_float_to_int<unsigned long long>("0.18446744073709551615e20",
+                                         ULimits::max(), OK);
+
+  // Overflow.
+  check_float_to_int<long long>("1e19", LLimits::max(), IntOverflow);
+  check_float_to_int<long long>("-1e19", LLimits::min(), IntOverflowNegative);
+  check_float_to_int<long long>("1e100000000", LLimits::max(), IntOverflow);
+  check_float_to_int<unsigned long long>("1.8446744073709551616e19",
+                                         ULimits::max(), IntOverflow);
+  check_float_to_int<short>("3.2768e4", 32767, NegativeLimit);
+  check_float_to_int<short>("-3.2768e4", -32768, OK);
+  check_float_to_int<short>("-3.27685e4", -32768, DoubleToInt);
+  check_float_to_int<short>("-3.2769e4", -32768, IntOverflowNegative);
+}
+
+
+static const unsigned HexFloatOptions = Floating | Prefix0x | HexFloating;
+
+
+BOOST_AUTO_TEST_CASE(HexFloatSyntaxTest) {
+  NumberRecognizer<> Recog(HexFloatOptions);
+
+  Recog.recognize(" -0x1A.8p+3 ");
+  BOOST_REQUIRE(Recog.success());
+  BOOST_REQUIRE(Recog.is_float());
+  BOOST_REQUIRE(Recog.has_binary_exp());
+  BOOST_REQUIRE(Recog.is_negative());
+  BOOST_REQUIRE(Recog.is_exp_positive());
+  BOOST_REQUIRE_EQUAL(Recog.get_base(), 16);
+  BOOST_REQUIRE_EQUAL(Recog.get_int_length(), 2);
+  BOOST_REQUIRE_EQUAL(Recog.get_frac_length(), 1);
+  BOOST_REQUIRE_EQUAL(Recog.get_exp_length(), 1);
+  BOOST_REQUIRE_EQUAL(Recog.get_trailing_ws(), 1);
+
+  // Fraction without integer part.
+  Recog.recognize("0x.8");
+  BOOST_REQUIRE(Recog.success());
+  BOOST_REQUIRE(Recog.has_binary_exp());
+  BOOST_REQUIRE_EQUAL(Recog.get_int_length(), 0);
+  BOOST_REQUIRE_EQUAL(Recog.get_frac_length(), 1);
+
+  // Letter 'e' is a digit, exponent starts with 'p'.
+  Recog.recognize("0x1.e");
+  BOOST_REQUIRE(Recog.success());
+  BOOST_REQUIRE_EQUAL(Recog.get_frac_length(), 1);
+  BOOST_REQUIRE_EQUAL(Recog.get_exp_length(), 0);
+  Recog.recognize("0x1P-2");
+  BOOST_REQUIRE(Recog.success());
+  BOOST_REQUIRE(Recog.is_exp_negative());
+
+  // Exponent must have digits, it is decimal.
+  Recog.recognize("0x1p");
+  BOOST_REQUIRE(Recog.partial());
+  BOOST_REQUIRE_EQUAL(Recog.get_number_length(), 3);
+  Recog.recognize("0x1p+a");
+  BOOST_REQUIRE(Recog.partial());
+  BOOST_REQUIRE_EQUAL(Recog.get_number_length(), 3);
+  Recog.recognize("0x1p1a");
+  BOOST_REQUIRE(Recog.partial());
+  BOOST_REQUIRE_EQUAL(Recog.get_number_length(), 5);
+
+  // Prefix without digits.
+  Recog.recognize("0x.");
+  BOOST_REQUIRE(Recog.partial());
+  BOOST_REQUIRE_EQUAL(Recog.get_base(), 10);
+  BOOST_REQUIRE_EQUAL(Recog.get_number_length(), 1);
+
+  // Decimal numbers are not affected.
+  Recog.recognize("1.5p3");
+  BOOST_REQUIRE(Recog.partial());
+  BOOST_REQUIRE(!Recog.has_binary_exp());
+  BOOST_REQUIRE_EQUAL(Recog.get_number_length(), 3);
+
+  // Without the option hexadecimal numbers are integers.
+  NumberRecognizer<> IntRecog(Floating | Prefix0x);
+  IntRecog.recognize("0x1.8p3");
+  BOOST_REQUIRE(IntRecog.partial());
+  BOOST_REQUIRE(!IntRecog.is_float());
+  BOOST_REQUIRE_EQUAL(IntRecog.get_number_length(), 3);
+  IntRecog.recognize("0x.8");
+  BOOST_REQUIRE(IntRecog.partial());
+  BOOST_REQUIRE_EQUAL(IntRecog.get_number_length(), 1);
+}
+
+
+template<typename NumType>
+static void check_hex_float(const char *text, NumType expected,
+                            Status expected_status) {
+  NumberRecognizer<> Recog(HexFloatOptions);
+  Recog.recognize(text);
+  NumType value;
+  Status status = Recog.read(value);
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(value, expected);
+  BOOST_TEST_INFO(text);
+  BOOST_REQUIRE_EQUAL(status, expected_status);
+}
+
+
+BOOST_AUTO_TEST_CASE(HexFloatTest) {
+  typedef std::numeric_limits<double> DLimits;
+  typedef std::numeric_limits<float> FLimits;
+
+  check_hex_float<double>("0x1.8p+3", 12.0, OK);
+  check_hex_float<double>("-0x1.8p1", -3.0, OK);
+  check_hex_float<double>("0xAp-2", 2.5, OK);
+  check_hex_float<double>("0x.1p4", 1.0, OK);
+  check_hex_float<double>("0x0.0p10", 0.0, OK);
+  check_hex_float<double>("0x0000000000000000001.0p0", 1.0, OK);
+  check_hex_float<double>("0x1.921fb54442d18p+1", 3.141592653589793, OK);
+  check_hex_float<float>("0x1.921fb6p+1", 3.14159274f, OK);
+  check_hex_float<long double>("0x1.8p-1", 0.75L, OK);
+
+  // Round half to even, digits beyond sixteen only break the tie.
+  check_hex_float<double>("0x1.00000000000008p0", 1.0, OK);
+  check_hex_float<double>("0x1.00000000000018p0",
+                          1.0 + 2 * DLimits::epsilon(), OK);
+  check_hex_float<double>("0x1.000000000000080000000001p0",
+                          1.0 + DLimits::epsilon(), OK);
+  check_hex_float<double>("0x1.fffffffffffff8p0", 2.0, OK);
+  check_hex_float<float>("0x1.000001p0", 1.0f, OK);
+  check_hex_float<float>("0x1.0000011p0", 1.0f + FLimits::epsilon(), OK);
+
+  // Denormals.
+  check_hex_float<double>("0x1p-1074", DLimits::denorm_min(), OK);
+  check_hex_float<double>("0x0.0000000000001p-1022", DLimits::denorm_min(),
+                          OK);
+  check_hex_float<double>("0x1.0000000000001p-1075", DLimits::denorm_min(),
+                          OK);
+  check_hex_float<double>("0x0.fffffffffffff8p-1022", DLimits::min(), OK);
+  check_hex_float<double>("0x1p-1075", 0.0, DoubleUnderflow);
+  check_hex_float<double>("-0x1p-2000", -0.0, DoubleUnderflow);
+  check_hex_float<float>("0x1p-149", FLimits::denorm_min(), OK);
+  check_hex_float<float>("0x1.000001p-150", FLimits::denorm_min(), OK);
+  check_hex_float<float>("0x1p-150", 0.0f, DoubleUnderflow);
+
+  // Overflow.
+  check_hex_float<double>("0x1.fffffffffffffp1023", DLimits::max(), OK);
+  check_hex_float<double>("0x1.fffffffffffff7ffp1023", DLimits::max(), OK);
+  check_hex_float<double>("0x1.fffffffffffff8p1023", DLimits::max(),
+                          DoubleOverflow);
+  check_hex_float<double>("-0x1p1024", -DLimits::max(),
+                          DoubleOverflowNegative);
+  check_hex_float<double>("0x1p99999999999", DLimits::max(), DoubleOverflow);
+  check_hex_float<float>("0x1.fffffep127", FLimits::max(), OK);
+  check_hex_float<float>("0x1.ffffffp127", FLimits::max(), DoubleOverflow);
+}
+
+
+BOOST_AUTO_TEST_CASE(HexFloatToIntTest) {
+  typedef std::numeric_limits<long long> LLimits;
+  typedef std::numeric_limits<unsigned long long> ULimits;
+
+  check_hex_float<int>("0x1.8p3", 12, OK);
+  check_hex_float<int>("0x1.8p0", 1, DoubleToInt);
+  check_hex_float<int>("-0x1.8p0", -1, DoubleToInt);
+  check_hex_float<int>("0x.8", 0, DoubleToInt);
+  check_hex_float<int>("0x1p-100000", 0, DoubleToInt);
+  check_hex_float<int>("0x0.0p100000", 0, OK);
+  check_hex_float<unsigned>("-0x.8", 0, DoubleToInt);
+  check_hex_float<unsigned>("-0x1.0p0", 0, IntOverflowNegative);
+
+  // Values above 2^53 are exact.
+  check_hex_float<long long>("0x1.0000000000001p62", (1LL << 62) + 1024, OK);
+  check_hex_float<long long>("0x7fffffffffffffff.0p0", LLimits::max(), OK);
+  check_hex_float<long long>("0x1.fffffffffffffffcp62", LLimits::max(), OK);
+  check_hex_float<long long>("-0x1p63", LLimits::min(), OK);
+  check_hex_float<long long>("0x1p63", LLimits::max(), NegativeLimit);
+  check_hex_float<unsigned long long>("0x.ffffffffffffffffp64",
+                                      ULimits::max(), OK);
+
+  // Overflow.
+  check_hex_float<long long>("0x1.0000000000000002p63", LLimits::max(),
+                             IntOverflow);
+  check_hex_float<long long>("-0x1.0000000000000002p63", LLimits::min(),
+                             IntOverflowNegative);
+  check_hex_float<unsigned long long>("0x1p64", ULimits::max(), IntOverflow);
+  check_hex_float<short>("0x1p15", 32767, NegativeLimit);
+  check_hex_float<short>("-0x1p15", -32768, OK);
+  check_hex_float<short>("0x1p99999999999", 32767, IntOverflow);
+}
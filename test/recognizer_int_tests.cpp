@@ -35,6 +35,7 @@
 //------ Dependencies ----------------------------------------------------------
 #include "conversion/number_recognizer.h"
 #include <boost/test/unit_test.hpp>
+#include <cmath>
 #include <memory>
 //------------------------------------------------------------------------------
 
@@ -440,3 +441,50 @@ BOOST_AUTO_TEST_CASE(Int4Test) {
   BOOST_REQUIRE_EQUAL(Recog.init(text).to<double>(), 123.0);
   BOOST_REQUIRE(Recog.get_status() == OK);
 }
+
+
+BOOST_AUTO_TEST_CASE(IntRangeTest) {
+  typedef std::numeric_limits<long long> LLimits;
+  NumberRecognizer<> Recog(DefaultOptions | Prefix0x);
+
+  long long llvalue = 111;
+  BOOST_REQUIRE(Recog.init("-9223372036854775808").read(llvalue) == OK);
+  BOOST_REQUIRE_EQUAL(llvalue, LLimits::min());
+  BOOST_REQUIRE(Recog.init("9223372036854775808").read(llvalue) ==
+                NegativeLimit);
+  BOOST_REQUIRE_EQUAL(llvalue, LLimits::max());
+  BOOST_REQUIRE(Recog.init("9223372036854775809").read(llvalue) ==
+                IntOverflow);
+  BOOST_REQUIRE_EQUAL(llvalue, LLimits::max());
+  BOOST_REQUIRE(Recog.init("-9223372036854775809").read(llvalue) ==
+                IntOverflowNegative);
+  BOOST_REQUIRE_EQUAL(llvalue, LLimits::min());
+  BOOST_REQUIRE(Recog.init("-99999999999999999999").read(llvalue) ==
+                IntOverflowNegative);
+  BOOST_REQUIRE_EQUAL(llvalue, LLimits::min());
+  BOOST_REQUIRE(Recog.get_status() == IntOverflowNegative);
+
+  // Negative numbers do not fit unsigned types, except for zero.
+  unsigned uvalue = 111;
+  BOOST_REQUIRE(Recog.init("-1").read(uvalue) == IntOverflowNegative);
+  BOOST_REQUIRE_EQUAL(uvalue, 0);
+  BOOST_REQUIRE(Recog.init("-99999999999").read(uvalue) ==
+                IntOverflowNegative);
+  BOOST_REQUIRE_EQUAL(uvalue, 0);
+  BOOST_REQUIRE(Recog.init("-0x10").read(uvalue) == IntOverflowNegative);
+  BOOST_REQUIRE_EQUAL(uvalue, 0);
+  uvalue = 111;
+  BOOST_REQUIRE(Recog.init("-0").read(uvalue) == OK);
+  BOOST_REQUIRE_EQUAL(uvalue, 0);
+
+  // Integers in power-of-two bases are rounded to nearest float.
+  double dvalue = 0;
+  BOOST_REQUIRE(Recog.init("0x1fffffffffffff1").read(dvalue) == OK);
+  BOOST_REQUIRE_EQUAL(dvalue, 144115188075855856.0);
+  BOOST_REQUIRE(Recog.init("0x1fffffffffffff8").read(dvalue) == OK);
+  BOOST_REQUIRE_EQUAL(dvalue, 144115188075855872.0);
+  BOOST_REQUIRE(Recog.init("-0x20000000000001000000000").read(dvalue) == OK);
+  BOOST_REQUIRE_EQUAL(dvalue, -std::ldexp(1.0, 89));
+  BOOST_REQUIRE(Recog.init("0x20000000000001000000001").read(dvalue) == OK);
+  BOOST_REQUIRE_EQUAL(dvalue, std::ldexp(1.0, 89) + std::ldexp(1.0, 37));
+}
@@ -0,0 +1,135 @@
+//===--- recognizer_static_tests.cpp ----------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///  Unit tests for recognizers with options fixed at compile time.
+///
+//===----------------------------------------------------------------------===//
+
+//------ Dependencies ----------------------------------------------------------
+#include "conversion/number_recognizer.h"
+#include <boost/test/unit_test.hpp>
+//------------------------------------------------------------------------------
+
+using namespace conversion;
+
+
+static const char *TestStrings[] = {
+  "", " ", "0", "-0", "+12", "  123  ", "0x1F", "0X", "0b101", "0b2", "0o17",
+  "0q17", "0o8", "017", "019", "0", "00012", "1.5", ".5", "5.", "-1.25e3",
+  "1e", "1e+", "2e-3x", "1.5 abc", "0x1.8p3", "ffff", "0xffffffff",
+  "18446744073709551616", "-9223372036854775808", "  +0b1111 ", "12abc"
+};
+
+
+// Checks that recognizer with fixed options produces the same results as the
+// one with the same options specified at run time.
+template<unsigned Options, unsigned char Base>
+static void compare_with_dynamic() {
+  for (const char *text : TestStrings) {
+    StaticNumberRecognizer<Options, Base> fixed(text);
+    NumberRecognizer<> dynamic(text, strlen(text), Options);
+    if (Base)
+      dynamic.set_base(Base);
+    fixed.recognize();
+    dynamic.recognize();
+
+    BOOST_TEST_INFO(text);
+    BOOST_REQUIRE_EQUAL(fixed.success(), dynamic.success());
+    BOOST_TEST_INFO(text);
+    BOOST_REQUIRE_EQUAL(fixed.partial(), dynamic.partial());
+    BOOST_TEST_INFO(text);
+    BOOST_REQUIRE_EQUAL(fixed.get_base(), dynamic.get_base());
+    BOOST_TEST_INFO(text);
+    BOOST_REQUIRE_EQUAL(fixed.is_float(), dynamic.is_float());
+    BOOST_TEST_INFO(text);
+    BOOST_REQUIRE_EQUAL(fixed.get_int_start(), dynamic.get_int_start());
+    BOOST_TEST_INFO(text);
+    BOOST_REQUIRE_EQUAL(fixed.get_int_length(), dynamic.get_int_length());
+    BOOST_TEST_INFO(text);
+    BOOST_REQUIRE_EQUAL(fixed.get_frac_length(), dynamic.get_frac_length());
+    BOOST_TEST_INFO(text);
+    BOOST_REQUIRE_EQUAL(fixed.get_exp_length(), dynamic.get_exp_length());
+    BOOST_TEST_INFO(text);
+    BOOST_REQUIRE_EQUAL(fixed.get_rest_start(), dynamic.get_rest_start());
+
+    long long fixed_value = 1, dynamic_value = 2;
+    Status fixed_status = fixed.read(fixed_value);
+    Status dynamic_status = dynamic.read(dynamic_value);
+    BOOST_TEST_INFO(text);
+    BOOST_REQUIRE_EQUAL(fixed_status, dynamic_status);
+    BOOST_TEST_INFO(text);
+    BOOST_REQUIRE_EQUAL(fixed_value, dynamic_value);
+  }
+}
+
+
+BOOST_AUTO_TEST_CASE(StaticOptionsTest) {
+  compare_with_dynamic<0, 0>();
+  compare_with_dynamic<0, 10>();
+  compare_with_dynamic<0, 16>();
+  compare_with_dynamic<0, 2>();
+  compare_with_dynamic<Floating, 0>();
+  compare_with_dynamic<Floating, 10>();
+  compare_with_dynamic<Prefix0x, 0>();
+  compare_with_dynamic<Prefix0x | Prefix0b | Prefix0o | Prefix0q, 0>();
+  compare_with_dynamic<Prefix0 | Floating, 0>();
+  compare_with_dynamic<Prefix0x | Prefix0b | Prefix0 | Floating, 0>();
+  compare_with_dynamic<Prefix0x | Prefix0b | Prefix0 | Floating, 8>();
+}
+
+
+BOOST_AUTO_TEST_CASE(StaticDecimalIntTest) {
+  StaticNumberRecognizer<0, 10> Recog;
+  BOOST_REQUIRE_EQUAL(Recog.get_options(), 0);
+  BOOST_REQUIRE(!Recog.is_allowed_float());
+  BOOST_REQUIRE(!Recog.is_allowed_0x());
+
+  // Run time options do not change behavior of the recognizer.
+  Recog.init("0x10", 4, Prefix0x | Floating);
+  BOOST_REQUIRE(Recog.recognize().partial());
+  BOOST_REQUIRE_EQUAL(Recog.get_base(), 10);
+  BOOST_REQUIRE_EQUAL(Recog.to<int>(), 0);
+
+  Recog.init(" -12345 ");
+  BOOST_REQUIRE(Recog.recognize().success());
+  BOOST_REQUIRE_EQUAL(Recog.to<int>(), -12345);
+
+  Recog.init("1.5");
+  BOOST_REQUIRE(Recog.recognize().partial());
+  BOOST_REQUIRE(!Recog.is_float());
+  BOOST_REQUIRE_EQUAL(Recog.to<double>(), 1.0);
+
+  StaticNumberRecognizer<Floating, 10, wchar_t> WideRecog(L"2.5e2");
+  BOOST_REQUIRE(WideRecog.recognize().success());
+  BOOST_REQUIRE_EQUAL(WideRecog.to<double>(), 250.0);
+
+  StaticNumberRecognizer<0, 16> HexRecog("7fFF");
+  BOOST_REQUIRE_EQUAL(HexRecog.to<int>(), 0x7FFF);
+}
@@ -1080,3 +1080,48 @@ BOOST_AUTO_TEST_CASE(BaseTest1) {
   BOOST_REQUIRE_EQUAL(value, 65535);
 }
 
+
+
+BOOST_AUTO_TEST_CASE(TrailingSpaceTest) {
+  NumberRecognizer<> Recog;
+
+  Recog.recognize("12 ");
+  BOOST_REQUIRE(Recog.success());
+  BOOST_REQUIRE_EQUAL(Recog.get_trailing_ws(), 1);
+  BOOST_REQUIRE_EQUAL(Recog.get_int_length(), 2);
+
+  Recog.recognize("12x");
+  BOOST_REQUIRE(Recog.partial());
+  BOOST_REQUIRE_EQUAL(Recog.get_rest_start(), 2);
+
+  Recog.recognize("12e");
+  BOOST_REQUIRE(Recog.partial());
+  BOOST_REQUIRE_EQUAL(Recog.get_rest_start(), 2);
+
+  // Integer only recognizer also skips trailing spaces.
+  NumberRecognizer<> IntRecog(0U);
+  IntRecog.recognize("0x1F\t ");
+  BOOST_REQUIRE(IntRecog.partial());
+  IntRecog.init(Prefix0x);
+  IntRecog.recognize("0x1F\t ");
+  BOOST_REQUIRE(IntRecog.success());
+  BOOST_REQUIRE_EQUAL(IntRecog.get_trailing_ws(), 2);
+  BOOST_REQUIRE_EQUAL(IntRecog.to<int>(), 0x1F);
+  IntRecog.recognize("0x1F x");
+  BOOST_REQUIRE(IntRecog.partial());
+  BOOST_REQUIRE_EQUAL(IntRecog.get_rest_start(), 5);
+}
+
+
+BOOST_AUTO_TEST_CASE(InitLengthTest) {
+  // Text is limited by the specified length, not by terminating null.
+  NumberRecognizer<> Recog;
+  Recog.init("12345", 3, DefaultOptions);
+  BOOST_REQUIRE(Recog.recognize().success());
+  BOOST_REQUIRE_EQUAL(Recog.size(), 3);
+  BOOST_REQUIRE_EQUAL(Recog.to<int>(), 123);
+
+  Recog.init("ff;", 2, DefaultOptions, 16);
+  BOOST_REQUIRE(Recog.recognize().success());
+  BOOST_REQUIRE_EQUAL(Recog.to<int>(), 0xFF);
+}
@@ -0,0 +1,176 @@
+//===--- stream_recognizer_tests.cpp ----------------------------*- C++ -*-===//
+//
+// Copyright(c) 2017, Serge Pavlov.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// - Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///  Unit tests for recognizer that gets text by portions.
+///
+//===----------------------------------------------------------------------===//
+
+//------ Dependencies ----------------------------------------------------------
+#include "conversion/stream_recognizer.h"
+#include "recognizer_checks.h"
+#include <boost/test/unit_test.hpp>
+#include <string>
+#include <vector>
+//------------------------------------------------------------------------------
+
+using namespace conversion;
+using namespace conversion::test;
+
+
+// Long numbers that do not fit digit buffer of the recognizer.
+static std::vector<std::string> make_long_strings() {
+  std::vector<std::string> result;
+  result.push_back("1" + std::string(900, '0'));
+  result.push_back("1" + std::string(900, '0') + "e-880");
+  result.push_back("1" + std::string(850, '0') + "1e-850");
+  result.push_back("0." + std::string(1000, '0') + "1e1001");
+  result.push_back("2." + std::string(790, '4') + "5" + std::string(100, '0'));
+  result.push_back("2." + std::string(790, '4') + "5" +
+                   std::string(100, '0') + "1");
+  // Halfway between 1 and the next double: 1 + 2^-53.
+  result.push_back("1.00000000000000011102230246251565404236316680908203125");
+  result.push_back("1.00000000000000011102230246251565404236316680908203125" +
+                   std::string(800, '0') + "1");
+  result.push_back("9007199254740993" + std::string(800, '0') + "e-800");
+  result.push_back("9007199254740993" + std::string(800, '0') + "1e-801");
+  result.push_back(std::string(300, ' ') + "42" + std::string(300, ' '));
+  return result;
+}
+
+
+// Feeds the text to stream recognizer by portions of the specified size.
+static void feed_by_portions(StreamNumberRecognizer<> &stream,
+                             const std::string &text, unsigned portion) {
+  unsigned pos = 0;
+  while (pos < text.size()) {
+    unsigned len = std::min<unsigned>(portion, text.size() - pos);
+    if (!stream.feed(text.data() + pos, len))
+      return;
+    pos += len;
+  }
+  stream.finish();
+}
+
+
+// Recognizes the text by two portions, split at every position.
+static void check_text(const std::string &text, unsigned opts,
+                       unsigned char base = 0) {
+  NumberRecognizer<> whole(text.c_str(), text.size(), opts);
+  whole.set_base(base);
+  whole.recognize();
+
+  for (unsigned split = 0; split <= text.size(); ++split) {
+    StreamNumberRecognizer<> stream(opts);
+    stream.set_base(base);
+    if (stream.feed(text.data(), split))
+      if (stream.feed(text.data() + split, text.size() - split))
+        stream.finish();
+    compare_parts(text, whole, stream);
+
+    // Values are checked for a few splits only, they do not depend on the
+    // way the text was passed.
+    if (split > 3 && split + 3 < text.size())
+      continue;
+    compare_values<double>(text, whole, stream);
+    compare_values<float>(text, whole, stream);
+    compare_values<int>(text, whole, stream);
+    compare_values<unsigned>(text, whole, stream);
+    compare_values<short>(text, whole, stream);
+    compare_values<long long>(text, whole, stream);
+    compare_values<unsigned long long>(text, whole, stream);
+  }
+
+  StreamNumberRecognizer<> stream(opts);
+  stream.set_base(base);
+  feed_by_portions(stream, text, 1);
+  compare_parts(text, whole, stream);
+  compare_values<double>(text, whole, stream);
+}
+
+
+BOOST_AUTO_TEST_CASE(StreamRecognizerTest) {
+  const unsigned AllPrefixes = Prefix0x | Prefix0o | Prefix0q | Prefix0b;
+  const unsigned OptionSets[] = {
+    DefaultOptions, 0, AllPrefixes, AllPrefixes | Floating,
+    AllPrefixes | Prefix0, Prefix0 | Floating
+  };
+  for (unsigned opts : OptionSets)
+    for (const char *text : RecognizerTestStrings)
+      check_text(text, opts);
+  for (const char *text : RecognizerTestStrings) {
+    check_text(text, AllPrefixes | Floating, 16);
+    check_text(text, DefaultOptions, 2);
+    check_text(text, DefaultOptions, 8);
+  }
+}
+
+
+BOOST_AUTO_TEST_CASE(StreamRecognizerLongTest) {
+  for (const std::string &text : make_long_strings()) {
+    check_text(text, DefaultOptions);
+    check_text(text, 0);
+  }
+}
+
+
+BOOST_AUTO_TEST_CASE(StreamRecognizerUsageTest) {
+  StreamNumberRecognizer<> recog;
+
+  BOOST_REQUIRE(recog.feed("  -12", 5));
+  BOOST_REQUIRE(recog.feed("34.5", 4));
+  BOOST_REQUIRE(recog.feed("e", 1));
+  BOOST_REQUIRE(!recog.feed("1 ;next", 7));
+  BOOST_REQUIRE(recog.partial());
+  BOOST_REQUIRE_EQUAL(recog.get_rest_start(), 12);
+  BOOST_REQUIRE_EQUAL(recog.to<double>(), -1234.5e1);
+
+  // Prefix is not allowed, 'x' terminates the number.
+  recog.reset();
+  BOOST_REQUIRE(!recog.feed("0x1F", 4));
+  BOOST_REQUIRE(recog.partial());
+  BOOST_REQUIRE_EQUAL(recog.get_rest_start(), 1);
+  BOOST_REQUIRE_EQUAL(recog.to<int>(), 0);
+
+  recog.reset(Prefix0x);
+  BOOST_REQUIRE(recog.feed("0x", 2));
+  BOOST_REQUIRE(recog.feed("1F", 2));
+  recog.finish();
+  BOOST_REQUIRE(recog.success());
+  BOOST_REQUIRE_EQUAL(recog.get_base(), 16);
+  BOOST_REQUIRE_EQUAL(recog.to<int>(), 31);
+
+  // Text is considered complete when the value is read.
+  recog.reset(DefaultOptions);
+  BOOST_REQUIRE(recog.feed("1e", 2));
+  int value;
+  BOOST_REQUIRE_EQUAL(recog.read(value), OK);
+  BOOST_REQUIRE(recog.partial());
+  BOOST_REQUIRE_EQUAL(value, 1);
+}